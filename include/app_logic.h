@@ -25,11 +25,29 @@ typedef struct
     app_logic_hsv_t color;
 } saved_color_entry_t;
 
+// Счетчики кэша вывода на светодиоды
+typedef struct
+{
+    uint32_t hits;       // Цвет не изменился, пересчет пропущен
+    uint32_t misses;     // Выполнен пересчет HSV -> RGB
+    uint32_t pwm_writes; // Выполнена запись в ШИМ
+} app_logic_render_stats_t;
+
+// Статистика записи во Flash (хранится на странице настроек)
+typedef struct
+{
+    uint32_t page_erases;       // Стираний страницы
+    uint32_t words_written;     // Записано слов
+    uint32_t commits_skipped;   // Сохранений без изменений (пропущены)
+    uint32_t nvmc_time_ms;      // Время в вызовах nrfx_nvmc
+} app_logic_flash_stats_t;
+
 // Инициализация логики приложения
 void app_logic_init(const int *id_digits);
 
-// Обработчик событий от кнопки (вызывается из button_handler)
-void app_logic_on_button_event(button_event_t event);
+// Обработка отложенных событий кнопки и таймеров.
+// Вызывается из основного цикла, все действия (в т.ч. запись во Flash) выполняются вне прерываний
+void app_logic_process(void);
 
 // Установка цвета в формате RGB
 void app_logic_set_rgb(uint16_t r, uint16_t g, uint16_t b);
@@ -37,6 +55,29 @@ void app_logic_set_rgb(uint16_t r, uint16_t g, uint16_t b);
 // Установка цвета в формате HSV
 void app_logic_set_hsv(uint16_t h, uint8_t s, uint8_t v);
 
+// Показ цвета без записи во Flash (для частых обновлений)
+void app_logic_show_rgb(uint16_t r, uint16_t g, uint16_t b);
+void app_logic_show_hsv(uint16_t h, uint8_t s, uint8_t v);
+
+// Показ цвета из прерывания: выполняется в app_logic_process(). Пока
+// событие в очереди, новые вызовы только заменяют цвет
+void app_logic_post_rgb(uint16_t r, uint16_t g, uint16_t b);
+
+// Сохранить текущее состояние во Flash (без изменений запись пропускается)
+void app_logic_save(void);
+
+// Текущий цвет
+void app_logic_get_current(app_logic_hsv_t * p_color);
+
+// Пакет команд: сохранения во Flash внутри пакета откладываются
+// и выполняются одной записью в app_logic_batch_end()
+void app_logic_batch_begin(void);
+void app_logic_batch_end(void);
+
+// Светодиоды менялись в обход app_logic (потоковый режим):
+// следующий вывод записывает ШИМ без проверки кэша
+void app_logic_render_invalidate(void);
+
 // Сохранить HSV цвет в список
 bool app_logic_save_color_hsv(uint16_t h, uint8_t s, uint8_t v, const char * name);
 
@@ -55,4 +96,10 @@ bool app_logic_apply_color(const char * name);
 // Получить список цветов
 const saved_color_entry_t * app_logic_get_list(uint8_t * count);
 
+// Получить счетчики кэша вывода (reset = сбросить после чтения)
+void app_logic_get_render_stats(app_logic_render_stats_t * p_stats, bool reset);
+
+// Получить статистику записи во Flash
+void app_logic_get_flash_stats(app_logic_flash_stats_t * p_stats);
+
 #endif
\ No newline at end of file
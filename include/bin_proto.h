@@ -0,0 +1,80 @@
+#ifndef BIN_PROTO_H
+#define BIN_PROTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Двоичный протокол управления цветом поверх того же порта CDC ACM, что и CLI.
+//
+// Кадр на линии: 0x00 <данные в COBS> 0x00. Текстовый CLI никогда не передает
+// байт 0x00, поэтому первый 0x00 переключает прием в двоичный режим, второй
+// завершает кадр. Кадры длиннее BIN_PROTO_MAX_ENCODED отбрасываются, и прием
+// возвращается к тексту.
+//
+// Кадр после декодирования COBS:
+//   [seq u8][cmd u8][данные...][crc16 LE]
+// crc16 - CRC-16/CCITT-FALSE (0xFFFF) по seq, cmd и данным.
+//
+// Ответ: [seq u8][cmd | 0x80][status u8][данные...][crc16 LE], в том же обрамлении.
+//
+// Цель по пропускной способности: не менее 1000 обновлений цвета в секунду.
+// SET_HSV занимает 11 байт на линии (6 байт + crc + COBS + два 0x00), ответ -
+// 8 байт: около 11 КБ/с к устройству и 8 КБ/с обратно. Хост не должен ждать
+// ответа на каждый кадр (оборот через USB занимает не меньше 1-2 мс): кадры
+// отправляются подряд, ответы сопоставляются по seq, и в пакет 64 байта
+// попадает до 5 команд. Команды SET_* не пишут во Flash, сохранение -
+// отдельной командой SAVE.
+
+// Максимальная длина кадра в COBS (без разделителей)
+#define BIN_PROTO_MAX_ENCODED   32
+// Максимум данных ответа (QUERY)
+#define BIN_PROTO_MAX_REPLY     5
+
+// Команды
+typedef enum
+{
+    BIN_CMD_SET_HSV = 0x01, // h u16 LE (0-360), s u8 (0-100), v u8 (0-100)
+    BIN_CMD_SET_RGB = 0x02, // r, g, b u8 (0-255)
+    BIN_CMD_APPLY   = 0x03, // имя сохраненного цвета (без завершающего нуля)
+    BIN_CMD_SAVE    = 0x04, // сохранить текущий цвет во Flash
+    BIN_CMD_QUERY   = 0x05, // ответ: h u16 LE, s u8, v u8, число сохраненных цветов u8
+} bin_proto_cmd_t;
+
+// Статус ответа
+typedef enum
+{
+    BIN_STATUS_OK          = 0,
+    BIN_STATUS_UNKNOWN_CMD = 1,
+    BIN_STATUS_BAD_LENGTH  = 2,
+    BIN_STATUS_NOT_FOUND   = 3,
+    BIN_STATUS_BAD_ARG     = 4,     // Значение вне диапазона (как у текстовых команд)
+} bin_proto_status_t;
+
+// Счетчики приема
+typedef struct
+{
+    uint32_t frames;        // Принято кадров с верной CRC
+    uint32_t crc_errors;    // Кадры с неверной CRC или ошибкой COBS (без ответа)
+    uint32_t overruns;      // Кадры длиннее BIN_PROTO_MAX_ENCODED
+    uint32_t seq_gaps;      // Пропуски в нумерации кадров
+    uint32_t tx_dropped;    // Ответы, не поместившиеся в буфер передачи
+} bin_proto_stats_t;
+
+// Отправка ответа в порт; false - ответ отброшен (передатчик не успевает)
+typedef bool (*bin_proto_write_t)(uint8_t const * p_data, size_t length);
+
+void bin_proto_init(bin_proto_write_t write);
+
+// Разбор входящего байта. true - байт относится к двоичному кадру,
+// false - байт текстовый и передается CLI
+bool bin_proto_rx_byte(uint8_t byte);
+
+void bin_proto_get_stats(bin_proto_stats_t * p_stats);
+
+// Выполнение команды без кадра и CRC (другие транспорты, usb_hid.h).
+// Данные ответа - в p_reply (не больше BIN_PROTO_MAX_REPLY байт). Основной цикл
+bin_proto_status_t bin_proto_execute(uint8_t cmd, uint8_t const * p_data, uint32_t data_len,
+                                     uint8_t * p_reply, uint32_t * p_reply_len);
+
+#endif
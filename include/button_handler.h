@@ -2,16 +2,78 @@
 #define BUTTON_HANDLER_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
-// Возможные события кнопки
+// Возможные события кнопки (жесты)
 typedef enum
 {
-    BUTTON_EVENT_PRESSED,       // Нажатие (начало удержания)
-    BUTTON_EVENT_RELEASED,      // Отпускание
-    BUTTON_EVENT_DOUBLE_CLICK   // Двойное нажатие
+    BUTTON_EVENT_CLICK,         // Одиночный клик
+    BUTTON_EVENT_DOUBLE_CLICK,  // Двойной клик
+    BUTTON_EVENT_TRIPLE_CLICK,  // Тройной клик
+    BUTTON_EVENT_LONG_PRESS,    // Начало удержания
+    BUTTON_EVENT_HOLD_REPEAT,   // Повтор во время удержания
+    BUTTON_EVENT_RELEASED,      // Отпускание после удержания
+    BUTTON_EVENT_COUNT
 } button_event_t;
 
-// Инициализация обработчика кнопки
-void button_handler_init(uint32_t button_pin);
+// Наибольшее число кнопок (отдельных и клавиш матрицы)
+#define BUTTON_MAX_COUNT        16
 
-#endif
\ No newline at end of file
+// Наибольшее число отдельных кнопок (ограничено каналами захвата TIMER3)
+#define BUTTON_MAX_PINS         5
+
+// Конфигурация кнопок. Идентификаторы событий: сначала отдельные кнопки
+// в порядке p_pins, затем клавиши матрицы (row * col_count + col).
+// Все кнопки активны по низкому уровню.
+typedef struct
+{
+    uint32_t const * p_pins;        // Отдельные кнопки
+    uint8_t          pin_count;
+    uint32_t const * p_row_pins;    // Строки матрицы (выходы)
+    uint8_t          row_count;
+    uint32_t const * p_col_pins;    // Столбцы матрицы (входы с подтяжкой)
+    uint8_t          col_count;
+} button_config_t;
+
+// Тайминги распознавания жестов (мс)
+typedef struct
+{
+    uint16_t debounce_ms;       // Тишина на линии для установления фронта
+    uint16_t click_gap_ms;      // Максимальная пауза между кликами серии
+    uint16_t long_press_ms;     // Порог удержания
+    uint16_t repeat_ms;         // Период повтора при удержании
+} button_timing_t;
+
+// Задержка классификации: от определяющего фронта до выдачи события (мкс)
+typedef struct
+{
+    uint32_t last_us[BUTTON_EVENT_COUNT];
+    uint32_t max_us[BUTTON_EVENT_COUNT];
+    uint32_t count[BUTTON_EVENT_COUNT];
+} button_latency_t;
+
+// Инициализация обработчика кнопок
+void button_handler_init(button_config_t const * p_config);
+
+// Количество сконфигурированных кнопок
+uint8_t button_handler_count(void);
+
+// Текущее время аппаратного таймера меток (мкс, 32 бита с переполнением)
+uint32_t button_handler_time_us(void);
+
+// Установка таймингов (false - недопустимые значения)
+bool button_handler_set_timing(button_timing_t const * p_timing);
+
+// Текущие тайминги
+void button_handler_get_timing(button_timing_t * p_timing);
+
+// Верхняя граница задержки классификации события при текущих таймингах (мкс)
+uint32_t button_handler_latency_bound_us(button_event_t event);
+
+// Статистика задержки классификации (reset = сбросить после чтения)
+void button_handler_get_latency(button_latency_t * p_latency, bool reset);
+
+// Имя события для вывода
+const char * button_handler_event_name(button_event_t event);
+
+#endif
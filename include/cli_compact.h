@@ -0,0 +1,40 @@
+#ifndef CLI_COMPACT_H
+#define CLI_COMPACT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+#include "nrf_cli.h"
+
+// Компактная замена nrf_cli для USB CLI (ESTC_USB_CLI_COMPACT=1).
+//
+// Работает через тот же транспорт nrf_cli_transport_t и вызывает те же
+// обработчики nrf_cli_cmd_handler, но без nrf_cli.c, nrf_queue.c, utf.c,
+// истории, автодополнения и секций команд. Команда ищется по совершенному
+// хешу, таблица которого строится при сборке scripts/cli_phash.py из
+// списка USB_CLI_COMMANDS в src/usb_cli.c (порядок таблицы команд должен
+// совпадать со списком).
+//
+// Строка: печатные символы, Backspace/DEL, конец - '\r' или '\n' (пара
+// CRLF/LFCR - один конец строки, как в nrf_cli). Аргументы разделяются
+// пробелами, кавычки не поддерживаются. nrf_cli_fprintf() реализована здесь
+// же и выводит без цветов.
+
+typedef struct
+{
+    const char *       p_name;
+    nrf_cli_cmd_handler handler;
+} cli_compact_cmd_t;
+
+// p_cmds - таблица команд в порядке USB_CLI_COMMANDS.
+// NRF_ERROR_INVALID_LENGTH - таблица хеша собрана для другого числа команд
+ret_code_t cli_compact_init(nrf_cli_transport_t const * p_transport, const char * p_prompt,
+                            cli_compact_cmd_t const * p_cmds, size_t count);
+
+// Разбор принятых символов и выполнение команд, вызывается в основном цикле
+void cli_compact_process(void);
+
+// Эхо вводимых символов
+void cli_compact_echo_set(bool on);
+
+#endif
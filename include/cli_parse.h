@@ -0,0 +1,36 @@
+#ifndef CLI_PARSE_H
+#define CLI_PARSE_H
+
+#include <stdint.h>
+
+// Разбор аргументов команд без выделения памяти.
+// Числа: десятичные ("255") или шестнадцатеричные ("0xFF"), без знака и пробелов.
+// Цвет: "#RRGGBB".
+
+typedef enum
+{
+    CLI_PARSE_OK,
+    CLI_PARSE_EMPTY,            // Пустая строка или префикс без цифр ("0x", "#")
+    CLI_PARSE_INVALID_CHAR,     // Недопустимый символ
+    CLI_PARSE_OVERFLOW,         // Не помещается в 32 бита
+    CLI_PARSE_OUT_OF_RANGE,     // Вне [min, max]
+    CLI_PARSE_BAD_LENGTH        // Цвет не из 6 шестнадцатеричных цифр
+} cli_parse_status_t;
+
+// Результат разбора: статус и смещение ошибочного символа в строке
+typedef struct
+{
+    cli_parse_status_t status;
+    uint8_t            offset;
+} cli_parse_result_t;
+
+// Целое в диапазоне [min, max]
+cli_parse_result_t cli_parse_uint(const char * p_str, uint32_t min, uint32_t max, uint32_t * p_value);
+
+// Цвет "#RRGGBB"
+cli_parse_result_t cli_parse_color(const char * p_str, uint8_t * p_r, uint8_t * p_g, uint8_t * p_b);
+
+// Описание статуса для вывода
+const char * cli_parse_status_str(cli_parse_status_t status);
+
+#endif
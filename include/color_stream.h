@@ -0,0 +1,60 @@
+#ifndef COLOR_STREAM_H
+#define COLOR_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Потоковый вывод цвета. Кадры от хоста копятся в буфере, а на светодиоды
+// выводятся с постоянной частотой по TIMER4, независимо от моментов прихода
+// пакетов USB.
+//
+// Кадр на линии: R G B 0xFF, значения 0-254 (0xFF - разделитель кадров).
+// Кадр другой длины отбрасывается. Лишний 0xFF после последнего кадра
+// (FF FF на линии) завершает поток, дальше снова работает CLI.
+// До первого верного кадра CR/LF в начале кадра (конец строки команды)
+// пропускаются, а одиночный 0xFF поток не завершает. Закрытие порта или
+// приостановка USB тоже завершают поток (usb_cli.c).
+//
+// Буфер сначала набирает depth кадров (задержка depth / rate).
+// Пустой буфер в момент вывода: цвет продолжается по двум последним кадрам
+// с уменьшающимся вдвое шагом, через STREAM_EXTRAPOLATE_MAX кадров
+// фиксируется. Переполнение: новый кадр отбрасывается, а очередь длиннее
+// 2 * depth сокращается до depth, чтобы задержка не росла.
+
+// Размер буфера (кадров, степень двойки)
+#define STREAM_BUF_SIZE             32
+
+#define STREAM_RATE_MIN_HZ          1
+#define STREAM_RATE_MAX_HZ          1000
+#define STREAM_DEPTH_DEFAULT        4
+
+// Кадров продолжения цвета при опустошении буфера
+#define STREAM_EXTRAPOLATE_MAX      4
+
+// Счетчики потока
+typedef struct
+{
+    uint32_t received;      // Принято кадров
+    uint32_t latched;       // Выведено кадров из буфера
+    uint32_t underruns;     // Выводов при пустом буфере
+    uint32_t overruns;      // Отброшено новых кадров (буфер полон)
+    uint32_t skipped;       // Отброшено старых кадров (сокращение задержки)
+    uint32_t bad_frames;    // Кадры неверной длины
+} color_stream_stats_t;
+
+// Запуск потока; false - параметры вне диапазона
+bool color_stream_start(uint32_t rate_hz, uint32_t depth);
+
+// Остановка вывода; последний выведенный цвет в шкале 0-1000
+void color_stream_stop(uint16_t * p_r, uint16_t * p_g, uint16_t * p_b);
+
+bool color_stream_is_active(void);
+
+// Разбор принятых данных на месте (основной цикл). *p_used - разобрано байт;
+// false - получен признак конца потока, данные после него не тронуты
+bool color_stream_rx(uint8_t const * p_data, size_t length, size_t * p_used);
+
+void color_stream_get_stats(color_stream_stats_t * p_stats);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Размер очереди событий
+#define EVENT_QUEUE_SIZE    16
+
+// Типы отложенных событий
+typedef enum
+{
+    APP_EVENT_BUTTON,       // Событие кнопки (button_event_t)
+    APP_EVENT_UPDATE_TICK,  // Тик таймера изменения значений
+    APP_EVENT_HOST_COLOR    // Цвет от хоста из прерывания (app_logic_post_rgb)
+} app_event_type_t;
+
+// Событие с меткой времени
+typedef struct
+{
+    uint8_t  type;          // app_event_type_t
+    uint8_t  arg;           // Параметр события (например, button_event_t)
+    uint8_t  id;            // Источник события (номер кнопки)
+    uint32_t timestamp_us;  // Время возникновения
+} app_event_t;
+
+// Инициализация очереди
+void event_queue_init(void);
+
+// Добавить событие (безопасно вызывать из прерывания)
+bool event_queue_put(app_event_t const * p_event);
+
+// Извлечь событие (вызывается из основного цикла)
+bool event_queue_get(app_event_t * p_event);
+
+// Количество событий, потерянных из-за переполнения
+uint32_t event_queue_dropped_count(void);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef MEM_MONITOR_H
+#define MEM_MONITOR_H
+
+#include <stdint.h>
+
+// Использование стека и кучи (байты)
+typedef struct
+{
+    uint32_t stack_size;        // Резерв __STACK_SIZE
+    uint32_t stack_peak;        // Максимум по окрашенной области
+    uint32_t stack_current;     // Текущая глубина
+    uint32_t heap_size;         // Резерв __HEAP_SIZE
+    uint32_t heap_peak;         // Максимум выделенного через _sbrk
+    uint32_t heap_in_use;       // Занято блоками malloc сейчас
+} mem_usage_t;
+
+// Область RAM по символам компоновщика
+typedef struct
+{
+    const char * name;
+    uint32_t     start;
+    uint32_t     size;
+} mem_section_t;
+
+// Окраска свободной части стека. Вызывается первой в main()
+void mem_monitor_init(void);
+
+// Текущее использование стека и кучи
+void mem_monitor_get(mem_usage_t * p_usage);
+
+// Области RAM (возвращает количество заполненных элементов)
+uint32_t mem_monitor_sections(mem_section_t * p_sections, uint32_t max_count);
+
+#endif
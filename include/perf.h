@@ -0,0 +1,96 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Точки замера: X(идентификатор, имя для вывода)
+#define PERF_PROBE_LIST(X)                          \
+    X(HSV_TO_RGB,         "hsv_to_rgb")             \
+    X(RGB_TO_HSV,         "rgb_to_hsv")             \
+    X(UPDATE_LEDS,        "update_leds")            \
+    X(FLASH_SAVE,         "flash_save")             \
+    X(CMD_RGB,            "cmd_rgb")                \
+    X(CMD_HSV,            "cmd_hsv")                \
+    X(CMD_ADD_RGB,        "cmd_add_rgb_color")      \
+    X(CMD_ADD_HSV,        "cmd_add_hsv_color")      \
+    X(CMD_ADD_CURRENT,    "cmd_add_current_color")  \
+    X(CMD_DEL,            "cmd_del_color")          \
+    X(CMD_APPLY,          "cmd_apply_color")        \
+    X(CMD_LIST,           "cmd_list_colors")        \
+    X(CMD_RENDER_STATS,   "cmd_render_stats")       \
+    X(CMD_FLASH_STATS,    "cmd_flash_stats")        \
+    X(CMD_BUTTON_TIMING,  "cmd_button_timing")      \
+    X(CMD_BUTTON_LATENCY, "cmd_button_latency")     \
+    X(CMD_HELP,           "cmd_help")               \
+    X(CMD_PERF,           "cmd_perf")               \
+    X(CMD_TRACE,          "cmd_trace")              \
+    X(CMD_MEM,            "cmd_mem")                \
+    X(CMD_BIN_STATS,      "cmd_bin_stats")          \
+    X(CMD_STREAM,         "cmd_stream")             \
+    X(CMD_USB_STATS,      "cmd_usb_stats")          \
+    X(CMD_MACHINE,        "cmd_machine")            \
+    X(CMD_STRIP,          "cmd_strip")              \
+    X(TMR_UPDATE,         "tmr_update")             \
+    X(TMR_BLINK,          "tmr_blink")              \
+    X(TMR_GESTURE,        "tmr_gesture")            \
+    X(TMR_DEBOUNCE,       "tmr_debounce")           \
+    X(TMR_MATRIX_SCAN,    "tmr_matrix_scan")        \
+    X(USB_RX_EVT,         "usb_rx_evt")             \
+    X(USB_RX_PARSE,       "usb_rx_parse")           \
+    X(CLI_LOOKUP,         "cli_lookup")
+
+#define PERF_PROBE_ENUM(id, name)   PERF_PROBE_##id,
+
+typedef enum
+{
+    PERF_PROBE_LIST(PERF_PROBE_ENUM)
+    PERF_PROBE_COUNT
+} perf_probe_t;
+
+// Корзины гистограммы: корзина i - длительность [2^(i-1), 2^i) тактов
+#define PERF_HIST_BINS      24
+
+// Статистика точки замера (в тактах CPU)
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint16_t hist[PERF_HIST_BINS];  // Насыщающиеся счетчики
+} perf_stats_t;
+
+#if ESTC_PERF_ENABLED
+
+#include "nrf.h"
+
+// Замер участка кода. Без ESTC_PERF_ENABLED макросы раскрываются в пустоту
+#define PERF_BEGIN(id)      uint32_t perf_start_##id = DWT->CYCCNT
+#define PERF_END(id)        perf_record(PERF_PROBE_##id, DWT->CYCCNT - perf_start_##id)
+
+void perf_record(perf_probe_t probe, uint32_t cycles);
+
+#else
+
+#define PERF_BEGIN(id)
+#define PERF_END(id)
+
+#endif
+
+// Запуск счетчика тактов DWT
+void perf_init(void);
+
+// Профилировщик включен при сборке
+bool perf_is_enabled(void);
+
+// Статистика точки замера
+void perf_get(perf_probe_t probe, perf_stats_t * p_stats);
+
+// Сброс всей статистики
+void perf_reset(void);
+
+// Имя точки замера для вывода
+const char * perf_probe_name(perf_probe_t probe);
+
+#endif
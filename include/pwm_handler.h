@@ -2,6 +2,7 @@
 #define PWM_HANDLER_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 // Режимы мигания индикатора
 typedef enum
@@ -21,4 +22,7 @@ void pwm_handler_set_rgb(uint16_t r, uint16_t g, uint16_t b);
 // Установка режима индикатора
 void pwm_handler_set_indicator_mode(pwm_indicator_mode_t mode);
 
+// ШИМ запущен (false - все каналы погашены, периферия остановлена)
+bool pwm_handler_is_running(void);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Размер кольцевого буфера трассы (записей)
+#define TRACE_BUF_SIZE      256
+
+// Этапы прохождения изменения от входа до светодиодов
+typedef enum
+{
+    TRACE_STAGE_BOOT,           // Старт прошивки (разделяет записи до и после сброса)
+    TRACE_STAGE_BTN_EDGE,       // Фронт кнопки (аппаратная метка), id - кнопка
+    TRACE_STAGE_BTN_DEBOUNCE,   // Окончание антидребезга, id - кнопка, arg - 1 нажата
+    TRACE_STAGE_APP_EVENT,      // Событие кнопки в app_logic, id - кнопка, arg - button_event_t
+    TRACE_STAGE_UPDATE_LEDS,    // Вход в update_leds
+    TRACE_STAGE_PWM_OUTPUT,     // Новое значение на выходе: arg 0 - SEQEND, 1 - ШИМ остановлен
+    TRACE_STAGE_CLI_RX,         // Получен конец строки команды
+    TRACE_STAGE_CLI_HANDLER,    // Вход в обработчик команды, arg - номер команды
+    TRACE_STAGE_HID_RX,         // Принят отчет HID, id - номер отчета, arg - команда
+    TRACE_STAGE_COUNT
+} trace_stage_t;
+
+// Запись трассы (8 байт)
+typedef struct
+{
+    uint32_t time_us;           // Время по button_handler_time_us()
+    uint8_t  stage;             // trace_stage_t
+    uint8_t  id;
+    uint16_t arg;
+} trace_record_t;
+
+#if ESTC_TRACE_ENABLED
+
+// Запись этапа. Без ESTC_TRACE_ENABLED макросы раскрываются в пустоту
+#define TRACE(stage, id, arg)               trace_record(TRACE_STAGE_##stage, trace_time_us(), (id), (arg))
+#define TRACE_AT(stage, time_us, id, arg)   trace_record(TRACE_STAGE_##stage, (time_us), (id), (arg))
+
+void trace_record(trace_stage_t stage, uint32_t time_us, uint8_t id, uint16_t arg);
+
+uint32_t trace_time_us(void);
+
+#else
+
+#define TRACE(stage, id, arg)
+#define TRACE_AT(stage, time_us, id, arg)
+
+#endif
+
+// Инициализация (буфер в .noinit переживает программный сброс)
+void trace_init(void);
+
+// Трассировка включена при сборке
+bool trace_is_enabled(void);
+
+// Приостановка записи (на время выгрузки)
+void trace_pause(bool pause);
+
+// Количество записей в буфере
+uint32_t trace_count(void);
+
+// Запись по номеру, 0 - самая старая
+bool trace_get(uint32_t index, trace_record_t * p_record);
+
+// Очистка буфера
+void trace_clear(void);
+
+// Имя этапа для вывода
+const char * trace_stage_name(trace_stage_t stage);
+
+#endif
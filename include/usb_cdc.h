@@ -0,0 +1,58 @@
+#ifndef USB_CDC_H
+#define USB_CDC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdk_errors.h"
+#include "app_usbd_class_base.h"
+
+// Порт CDC ACM для CLI и двоичных протоколов.
+//
+// Прием: app_usbd_cdc_acm_read_any() пишет пакеты USB прямо в блоки
+// кольцевого буфера (USB_CDC_RX_BLOCKS по 64 байта), разборщики читают
+// данные на месте через usb_cdc_rx_peek()/usb_cdc_rx_consume().
+// Пока все блоки заняты, новый прием не запускается и хост получает NAK.
+
+// Блоков приема (степень двойки)
+#define USB_CDC_RX_BLOCKS       8
+// Размер блока - один пакет bulk USB FS
+#define USB_CDC_RX_BLOCK_SIZE   64
+
+typedef enum
+{
+    USB_CDC_EVT_RX,         // Получен пакет
+    USB_CDC_EVT_TX_DONE,    // Передача завершена
+    USB_CDC_EVT_PORT_CLOSED // Хост закрыл порт
+} usb_cdc_evt_t;
+
+// Вызывается из прерывания USB
+typedef void (*usb_cdc_handler_t)(usb_cdc_evt_t event);
+
+// Счетчики приема с момента сброса
+typedef struct
+{
+    uint32_t rx_bytes;
+    uint32_t rx_packets;
+    uint32_t rx_stalls;     // Буфер полон, прием приостанавливался
+    uint32_t elapsed_us;    // Время с момента сброса
+} usb_cdc_stats_t;
+
+void usb_cdc_init(usb_cdc_handler_t handler);
+
+// Экземпляр класса для app_usbd_class_append()
+app_usbd_class_inst_t const * usb_cdc_class_inst(void);
+
+// Непрочитанные данные самого старого блока: длина и указатель в буфер приема
+size_t usb_cdc_rx_peek(uint8_t const ** pp_data);
+
+// Отметить length байт блока прочитанными; освобожденный блок снова принимает данные
+void usb_cdc_rx_consume(size_t length);
+
+// Передача: данные копируются (не больше пакета за вызов), *p_cnt - принято байт.
+// *p_cnt = 0 - передатчик занят, USB_CDC_EVT_TX_DONE сообщит об освобождении
+ret_code_t usb_cdc_write(void const * p_data, size_t length, size_t * p_cnt);
+
+void usb_cdc_get_stats(usb_cdc_stats_t * p_stats, bool reset);
+
+#endif
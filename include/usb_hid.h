@@ -0,0 +1,58 @@
+#ifndef USB_HID_H
+#define USB_HID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_usbd_class_base.h"
+
+// Интерфейс HID рядом с CDC ACM (составное устройство) для управления
+// с малой и предсказуемой задержкой.
+//
+// Конечные точки interrupt IN и OUT с опросом раз в 1 мс: хост передает
+// отчет не позже чем через 1 мс после записи, без текстового разбора и
+// очереди bulk. Драйвер HID есть в любой ОС (hidraw, hidapi).
+//
+// Отчеты, первый байт - номер отчета:
+//   1 OUT, цвет:   [1][r u16 LE][g u16 LE][b u16 LE], шкала ШИМ 0-1000.
+//                  Передается в app_logic через очередь событий и выводится
+//                  в основном цикле как текущий цвет, без записи во Flash
+//                  (задержка до светодиода - опрос 1 мс + проход основного
+//                  цикла + период ШИМ 1 мс). Отчеты, пришедшие до вывода
+//                  предыдущего, заменяют его цвет.
+//   2 OUT, команда: [2][seq u8][cmd u8][len u8][данные], команды и данные
+//                  как в bin_proto.h, без COBS и CRC (целостность - USB).
+//                  Выполняется в основном цикле.
+//   2 IN,  ответ:  [2][seq u8][cmd | 0x80][status u8][len u8][данные].
+//
+// Команды, пришедшие при полной очереди, отбрасываются без ответа.
+
+// Данные отчетов без номера отчета
+#define USB_HID_COLOR_REPORT_SIZE   6
+#define USB_HID_CMD_REPORT_SIZE     31
+#define USB_HID_CMD_DATA_MAX        (USB_HID_CMD_REPORT_SIZE - 3)
+
+// Команд в очереди к основному циклу (степень двойки)
+#define USB_HID_CMD_QUEUE_SIZE      4
+
+// Счетчики отчетов с момента сброса
+typedef struct
+{
+    uint32_t color_reports;     // Выведено цветов
+    uint32_t cmd_reports;       // Выполнено команд
+    uint32_t cmd_dropped;       // Очередь команд была полна
+    uint32_t bad_reports;       // Неизвестный номер или неверная длина
+    uint32_t reply_dropped;     // Очередь ответов IN была полна
+} usb_hid_stats_t;
+
+// Экземпляр класса для app_usbd_class_append()
+app_usbd_class_inst_t const * usb_hid_class_inst(void);
+
+// Выполнение принятых команд, вызывается в основном цикле
+void usb_hid_process(void);
+
+void usb_hid_get_stats(usb_hid_stats_t * p_stats, bool reset);
+
+// false - собрано без ESTC_USB_HID_ENABLED
+bool usb_hid_is_enabled(void);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef WS2812_HANDLER_H
+#define WS2812_HANDLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Максимальная длина ленты (определяет размер DMA буферов)
+#ifndef WS2812_MAX_PIXELS
+#define WS2812_MAX_PIXELS   64
+#endif
+
+// Статистика вывода кадров
+typedef struct
+{
+    uint32_t frames_shown;    // Кадров передано в ленту
+    uint32_t frames_replaced; // Кадров перезаписано до начала передачи
+} ws2812_stats_t;
+
+// Инициализация вывода на адресную ленту (PWM1 + EasyDMA)
+void ws2812_handler_init(uint32_t data_pin, uint16_t pixel_count);
+
+// Смена длины ленты (не больше WS2812_MAX_PIXELS), пока кадр не передается.
+// false - идет передача
+bool ws2812_handler_set_length(uint16_t pixel_count);
+
+// Текущая длина ленты
+uint16_t ws2812_handler_length(void);
+
+// Установка цвета пикселя в буфере кадра (0-255)
+void ws2812_handler_set_pixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b);
+
+// Заливка всего буфера кадра одним цветом
+void ws2812_handler_fill(uint8_t r, uint8_t g, uint8_t b);
+
+// Кодирование кадра во второй DMA буфер и запуск передачи.
+// Пока текущий кадр выдвигается в ленту, следующий готовится параллельно.
+void ws2812_handler_show(void);
+
+// Идет ли передача кадра
+bool ws2812_handler_is_busy(void);
+
+// Время передачи одного кадра в микросекундах.
+// 30 мкс на пиксель + 300 мкс сброса: 64 пикс. ~ 2.2 мс (~450 кадр/с),
+// 300 пикс. ~ 9.3 мс (~107 кадр/с).
+uint32_t ws2812_handler_frame_time_us(void);
+
+// Получить статистику
+void ws2812_handler_get_stats(ws2812_stats_t * p_stats);
+
+#endif
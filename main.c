@@ -4,10 +4,16 @@
 #include "nrf_log.h"
 #include "nrf_log_ctrl.h"
 #include "nrf_log_default_backends.h"
+#include "nrf_pwr_mgmt.h"
 
 #include "button_handler.h"
 #include "pwm_handler.h"
+#include "ws2812_handler.h"
 #include "app_logic.h"
+#include "event_queue.h"
+#include "perf.h"
+#include "trace.h"
+#include "mem_monitor.h"
 #include "usb_cli.h"
 
 #define LED_1_Y_PIN     6
@@ -15,6 +21,9 @@
 #define LED_2_G_PIN     41
 #define LED_2_B_PIN     12
 #define BUTTON_1_PIN    38
+// Адресная лента WS2812 на свободном выводе P0.29
+#define WS2812_DATA_PIN 29
+#define WS2812_PIXELS   8
 
 static const int id_digits[4] = { 6, 6, 0, 6 };
 
@@ -25,6 +34,16 @@ static const uint32_t led_pins[4] = {
     LED_2_B_PIN
 };
 
+static const uint32_t button_pins[] = {
+    BUTTON_1_PIN
+};
+
+// Матрица не подключена
+static const button_config_t button_config = {
+    .p_pins    = button_pins,
+    .pin_count = ARRAY_SIZE(button_pins),
+};
+
 static void log_init(void)
 {
     ret_code_t err_code = NRF_LOG_INIT(NULL);
@@ -36,6 +55,9 @@ int main(void)
 {
     ret_code_t err_code;
 
+    // До любой другой работы: окраска свободного стека
+    mem_monitor_init();
+
     err_code = nrf_drv_clock_init();
     APP_ERROR_CHECK(err_code);
     nrf_drv_clock_lfclk_request(NULL);
@@ -45,12 +67,24 @@ int main(void)
     APP_ERROR_CHECK(err_code);
 
     log_init();
+
+    perf_init();
+
+    err_code = nrf_pwr_mgmt_init();
+    APP_ERROR_CHECK(err_code);
     
     app_timer_init();
 
+    event_queue_init();
+
     pwm_handler_init(led_pins);
 
-    button_handler_init(BUTTON_1_PIN);
+    ws2812_handler_init(WS2812_DATA_PIN, WS2812_PIXELS);
+
+    button_handler_init(&button_config);
+
+    // Метки трассы берутся от таймера кнопок
+    trace_init();
 
     app_logic_init(id_digits);
 
@@ -58,11 +92,13 @@ int main(void)
 
     while (1)
     {
+        app_logic_process();
+
         usb_cli_process();
 
         if (NRF_LOG_PROCESS() == false)
         {
-            __WFE();
+            nrf_pwr_mgmt_run();
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""Round-trip latency and throughput of USB CLI commands.
+
+Usage: cli_bench.py <port> [--count N] [command ...]
+
+Works against the board (/dev/ttyACM0) and the host simulator (the pty
+printed by 'make -C sim run'). Each command is sent N times and the time
+from writing the line to receiving the next prompt is measured, so the
+result includes the transport, line parsing, the handler and the output.
+The defaults do not write to flash. The port is opened as a raw tty, no
+pyserial is needed.
+"""
+
+import argparse
+import os
+import select
+import sys
+import termios
+import time
+import tty
+
+PROMPT = b"usb_cli:~$ "
+TIMEOUT_S = 2.0
+
+DEFAULT_COMMANDS = ["render_stats", "flash_stats", "button_latency", "list_colors", "help"]
+
+
+def command(fd, line):
+    """Send a CLI command and return its output once the prompt arrives."""
+    os.write(fd, line.encode() + b"\r")
+    output = b""
+    deadline = time.monotonic() + TIMEOUT_S
+    while not output.endswith(PROMPT):
+        if not select.select([fd], [], [], max(0, deadline - time.monotonic()))[0]:
+            sys.exit("no prompt after '%s'" % line)
+        chunk = os.read(fd, 4096)
+        if not chunk:
+            sys.exit("port closed")
+        output += chunk
+    return output
+
+
+def percentile(values, p):
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    parser.add_argument("--count", type=int, default=200, help="runs per command")
+    parser.add_argument("commands", nargs="*", default=DEFAULT_COMMANDS)
+    args = parser.parse_args()
+
+    fd = os.open(args.port, os.O_RDWR | os.O_NOCTTY)
+    try:
+        tty.setraw(fd)
+        termios.tcflush(fd, termios.TCIOFLUSH)
+        command(fd, "machine off")
+
+        print("%-16s %6s %8s %8s %8s %8s %9s" % ("command", "runs", "min_us", "avg_us",
+                                                 "p99_us", "max_us", "cmd/s"))
+        for name in args.commands:
+            times = []
+            size = 0
+            start = time.monotonic()
+            for _ in range(args.count):
+                t0 = time.monotonic()
+                size += len(command(fd, name))
+                times.append((time.monotonic() - t0) * 1e6)
+            total = time.monotonic() - start
+
+            times.sort()
+            print("%-16s %6d %8.0f %8.0f %8.0f %8.0f %9.0f  (%d bytes/reply)" % (
+                name, len(times), times[0], sum(times) / len(times), percentile(times, 99),
+                times[-1], len(times) / total, size // len(times)))
+    finally:
+        os.close(fd)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Per-command CLI dispatch latency from the device trace.
+
+Usage: cli_latency.py <port> [--count N] [command ...]
+
+The firmware must be built with ESTC_TRACE_ENABLED=1. Each command is sent
+N times; the device records 'cli_rx' when the line end is parsed and
+'cli_handler' on entry to the handler, so the difference is the time spent
+in line editing, tokenizing and command lookup. Run once against an nrf_cli
+build and once against ESTC_USB_CLI_COMPACT=1 (see 'make cli-compare').
+Only commands wrapped with a probe (X entries of USB_CLI_COMMANDS) are
+traced. The defaults do not write to flash. Requires pyserial.
+"""
+
+import argparse
+import sys
+import time
+
+try:
+    import serial
+except ImportError:
+    sys.exit("pyserial is required: pip install pyserial")
+
+DEFAULT_COMMANDS = ["render_stats", "flash_stats", "button_timing", "button_latency", "list_colors", "help"]
+
+
+def command(port, line, quiet=0.2):
+    """Send a CLI command and return the output once the device goes quiet."""
+    port.reset_input_buffer()
+    port.write(line.encode() + b"\r")
+    output = b""
+    deadline = time.monotonic() + quiet
+    while time.monotonic() < deadline:
+        chunk = port.read(port.in_waiting or 1)
+        if chunk:
+            output += chunk
+            deadline = time.monotonic() + quiet
+    return output.decode(errors="replace")
+
+
+def dispatch_times(csv):
+    """cli_handler time minus the preceding cli_rx time, in us."""
+    times = []
+    rx_time = None
+    for line in csv.splitlines():
+        fields = line.strip().split(",")
+        if len(fields) != 4 or not fields[0].isdigit():
+            continue
+        if fields[1] == "cli_rx":
+            rx_time = int(fields[0])
+        elif fields[1] == "cli_handler" and rx_time is not None:
+            times.append(int(fields[0]) - rx_time)
+            rx_time = None
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    parser.add_argument("--count", type=int, default=50, help="runs per command (trace holds 256 records)")
+    parser.add_argument("commands", nargs="*", default=DEFAULT_COMMANDS)
+    args = parser.parse_args()
+
+    with serial.Serial(args.port, timeout=0.05) as port:
+        command(port, "machine on")
+        if "disabled" in command(port, "trace"):
+            sys.exit("tracer disabled: build with ESTC_TRACE_ENABLED=1")
+
+        print("%-16s %5s %8s %8s %8s (us)" % ("command", "runs", "min", "avg", "max"))
+        for name in args.commands:
+            command(port, "trace clear")
+            for _ in range(args.count):
+                command(port, name, quiet=0.05)
+
+            times = dispatch_times(command(port, "trace csv", quiet=0.5))
+            if not times:
+                print("%-16s no trace records" % name)
+                continue
+            print("%-16s %5d %8d %8.1f %8d" % (name, len(times), min(times),
+                                                sum(times) / len(times), max(times)))
+
+        command(port, "machine off")
+
+
+if __name__ == "__main__":
+    main()
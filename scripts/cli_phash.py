@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Perfect hash table for the compact USB CLI dispatcher.
+
+Usage: cli_phash.py <usb_cli.c> <cli_phash.h>
+
+Reads the command names from the USB_CLI_COMMANDS list in src/usb_cli.c and
+writes a header for src/cli_compact.c. The hash is 32-bit FNV-1a with a
+searched seed as the offset basis; the top CLI_PHASH_BITS bits select a slot
+in a power-of-two table with at least two slots per command, so a seed
+without collisions is found within a few dozen attempts. Each slot holds the
+command index + 1 (0 - empty).
+"""
+
+import re
+import sys
+
+FNV_PRIME = 16777619
+MAX_SEED_ATTEMPTS = 1 << 20
+
+
+def command_names(source):
+    """Names from the X(...)/Y(...) entries of the USB_CLI_COMMANDS macro, in order."""
+    lines = source.splitlines()
+    start = next((i for i, line in enumerate(lines)
+                  if line.startswith("#define USB_CLI_COMMANDS(")), None)
+    if start is None:
+        sys.exit("USB_CLI_COMMANDS list not found")
+
+    names = []
+    for line in lines[start + 1:]:
+        match = re.match(r"\s*[XY]\(\s*(\w+)\s*,", line)
+        if match:
+            names.append(match.group(1))
+        if not line.rstrip().endswith("\\"):
+            break
+    return names
+
+
+def fnv1a(name, seed):
+    value = seed
+    for byte in name.encode():
+        value = ((value ^ byte) * FNV_PRIME) & 0xFFFFFFFF
+    return value
+
+
+def find_seed(names, bits):
+    for seed in range(MAX_SEED_ATTEMPTS):
+        slots = {fnv1a(name, seed) >> (32 - bits) for name in names}
+        if len(slots) == len(names):
+            return seed
+    sys.exit("no collision-free seed for %d commands in %d slots" % (len(names), 1 << bits))
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__.strip().splitlines()[2])
+
+    with open(sys.argv[1]) as source:
+        names = command_names(source.read())
+    if not names or len(names) > 255:
+        sys.exit("expected 1-255 commands, found %d" % len(names))
+    if len(set(names)) != len(names):
+        sys.exit("duplicate command names")
+
+    bits = max(1, (2 * len(names) - 1).bit_length())
+    seed = find_seed(names, bits)
+
+    table = [0] * (1 << bits)
+    for index, name in enumerate(names):
+        table[fnv1a(name, seed) >> (32 - bits)] = index + 1
+
+    rows = ["    " + ", ".join("%3d" % v for v in table[i:i + 16]) + ","
+            for i in range(0, len(table), 16)]
+
+    with open(sys.argv[2], "w") as header:
+        header.write("// Generated by scripts/cli_phash.py from %s, do not edit\n" % sys.argv[1])
+        header.write("// Commands: %s\n" % " ".join(names))
+        header.write("#ifndef CLI_PHASH_H\n#define CLI_PHASH_H\n\n")
+        header.write("#include <stdint.h>\n\n")
+        header.write("#define CLI_PHASH_SEED      0x%08Xu\n" % seed)
+        header.write("#define CLI_PHASH_BITS      %d\n" % bits)
+        header.write("#define CLI_PHASH_COUNT     %d\n\n" % len(names))
+        header.write("static const uint8_t m_cli_phash_slots[1 << CLI_PHASH_BITS] = {\n")
+        header.write("\n".join(rows) + "\n};\n\n#endif\n")
+
+
+if __name__ == "__main__":
+    main()
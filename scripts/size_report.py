@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""Per-module flash/RAM usage from a GNU ld map file.
+
+Usage: size_report.py <map> [--budget module=flash[:ram] ...]
+
+Modules are project objects (main.c, src/*.c) and SDK/toolchain libraries
+grouped by object name. 'total' budgets the whole image. Exits with 1 when
+any budget is exceeded.
+"""
+
+import argparse
+import re
+import sys
+from collections import defaultdict
+
+# SDK objects grouped by library (object file name prefix -> module)
+SDK_GROUPS = [
+    ("nrf_cli", "nrf_cli"),
+    ("app_usbd", "app_usbd"),
+    ("nrfx_usbd", "app_usbd"),
+    ("nrf_log", "nrf_log"),
+    ("nrf_fprintf", "nrf_fprintf"),
+    ("nrf_drv_", "nrfx"),
+    ("nrfx_", "nrfx"),
+    ("nrf_atfifo", "nrf_atfifo"),
+    ("nrf_queue", "nrf_queue"),
+    ("nrf_ringbuf", "nrf_ringbuf"),
+    ("nrf_pwr_mgmt", "nrf_pwr_mgmt"),
+    ("nrf_section_iter", "nrf_section_iter"),
+    ("app_timer", "app_timer"),
+    ("app_error", "app_error"),
+    ("app_util", "app_util"),
+    ("gcc_startup", "startup"),
+    ("system_nrf52840", "startup"),
+]
+
+# Toolchain archives: libc_nano.a(lib_a-memcpy.o) -> libc
+ARCHIVE_GROUPS = [
+    ("libc", "libc"),
+    ("libm", "libm"),
+    ("libgcc", "libgcc"),
+    ("libnosys", "libnosys"),
+]
+
+MEMORY_RE = re.compile(r"^(\w+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+OUTPUT_RE = re.compile(r"^(\.\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?(.*)$")
+INPUT_RE = re.compile(r"^\s+(\S+)?\s*0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+
+def module_name(obj, project):
+    archive = re.match(r"^.*/([^/(]+)\.a\(", obj)
+    if archive:
+        lib = archive.group(1)
+        for prefix, group in ARCHIVE_GROUPS:
+            if lib.startswith(prefix):
+                return group
+        return lib
+
+    name = obj.rsplit("/", 1)[-1]
+    name = re.sub(r"\.o$", "", name)
+    if name in project:
+        return name
+    for prefix, group in SDK_GROUPS:
+        if name.startswith(prefix):
+            return group
+    return name
+
+
+def parse_map(path, project):
+    regions = {}
+    flash = defaultdict(int)
+    ram = defaultdict(int)
+
+    with open(path) as f:
+        lines = f.read().splitlines()
+
+    # Memory regions
+    i = 0
+    while i < len(lines) and not lines[i].startswith("Memory Configuration"):
+        i += 1
+    for line in lines[i:]:
+        if line.startswith("Linker script and memory map"):
+            break
+        m = MEMORY_RE.match(line)
+        if m and m.group(1) in ("FLASH", "RAM"):
+            regions[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+
+    if "FLASH" not in regions or "RAM" not in regions:
+        sys.exit("size_report: FLASH/RAM regions not found in " + path)
+
+    def region_of(addr):
+        for name, (origin, length) in regions.items():
+            if origin <= addr < origin + length:
+                return name
+        return None
+
+    in_map = False
+    loaded = False          # Output section has a flash load address (.data)
+    pending_name = None     # Long input section name printed on its own line
+    for line in lines:
+        if line.startswith("Linker script and memory map"):
+            in_map = True
+            continue
+        if not in_map:
+            continue
+        if line.startswith("/DISCARD/"):
+            break
+
+        out = OUTPUT_RE.match(line)
+        if out:
+            loaded = "load address" in (out.group(4) or "")
+            pending_name = None
+            continue
+
+        m = INPUT_RE.match(line)
+        if not m:
+            # " .text.long_name" without address - continued on the next line
+            stripped = line.strip()
+            pending_name = stripped if stripped.startswith(".") and " " not in stripped else None
+            continue
+
+        name = m.group(1) or pending_name
+        pending_name = None
+        addr = int(m.group(2), 16)
+        size = int(m.group(3), 16)
+        obj = m.group(4).strip()
+
+        if size == 0 or name is None or name == "*fill*" or not obj.endswith(("o", ")")):
+            continue
+
+        module = module_name(obj, project)
+        region = region_of(addr)
+        if region == "FLASH":
+            flash[module] += size
+        elif region == "RAM":
+            ram[module] += size
+            if loaded:
+                flash[module] += size
+
+    return flash, ram
+
+
+def parse_budget(entries):
+    budgets = {}
+    for entry in entries:
+        module, _, limits = entry.partition("=")
+        flash_limit, _, ram_limit = limits.partition(":")
+        budgets[module] = (int(flash_limit or "0", 0), int(ram_limit or "0", 0))
+    return budgets
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map")
+    parser.add_argument("--project", nargs="*", default=[],
+                        help="project source names reported individually (main.c app_logic.c ...)")
+    parser.add_argument("--budget", nargs="*", default=[],
+                        help="module=flash[:ram] in bytes, 0 - no limit; 'total' for the image")
+    args = parser.parse_args()
+
+    flash, ram = parse_map(args.map, set(args.project))
+    budgets = parse_budget(args.budget)
+
+    modules = sorted(set(flash) | set(ram), key=lambda m: (-flash[m], m))
+    total_flash = sum(flash.values())
+    total_ram = sum(ram.values())
+
+    print("%-24s %9s %9s" % ("module", "flash", "ram"))
+    for module in modules:
+        print("%-24s %9d %9d" % (module, flash[module], ram[module]))
+    print("%-24s %9d %9d" % ("total", total_flash, total_ram))
+
+    failed = False
+    for module, (flash_limit, ram_limit) in sorted(budgets.items()):
+        used_flash = total_flash if module == "total" else flash[module]
+        used_ram = total_ram if module == "total" else ram[module]
+        if flash_limit and used_flash > flash_limit:
+            print("BUDGET EXCEEDED: %s flash %d > %d" % (module, used_flash, flash_limit))
+            failed = True
+        if ram_limit and used_ram > ram_limit:
+            print("BUDGET EXCEEDED: %s ram %d > %d" % (module, used_ram, ram_limit))
+            failed = True
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
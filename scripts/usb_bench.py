@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""Sustained host-to-device throughput over the CLI CDC ACM port.
+
+Usage: usb_bench.py <port> [--kbytes N] [--rate HZ]
+
+Switches the device into stream mode, sends N KB of RGB frames as fast as
+the port accepts them, leaves stream mode and prints the device-side
+'usb_stats' report (bytes/s, stalls, CPU cycles per KB when the firmware is
+built with ESTC_PERF_ENABLED=1). Requires pyserial.
+"""
+
+import argparse
+import sys
+import time
+
+try:
+    import serial
+except ImportError:
+    sys.exit("pyserial is required: pip install pyserial")
+
+FRAME_END = b"\xff"
+
+
+def command(port, line, wait=0.2):
+    """Send a CLI command and return whatever the device printed."""
+    port.reset_input_buffer()
+    port.write(line.encode() + b"\r")
+    time.sleep(wait)
+    return port.read(port.in_waiting or 1).decode(errors="replace")
+
+
+def frames(kbytes):
+    """RGB ramp frames (R G B 0xFF, values 0-254) totalling ~kbytes KB."""
+    frame_count = kbytes * 1024 // 4
+    chunk = bytearray()
+    for i in range(256):
+        v = i % 255
+        chunk += bytes((v, 254 - v, (v * 7) % 255)) + FRAME_END
+    data = bytes(chunk) * (frame_count // 256 + 1)
+    return data[:frame_count * 4]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    parser.add_argument("--kbytes", type=int, default=256)
+    parser.add_argument("--rate", type=int, default=1000, help="stream latch rate, Hz")
+    args = parser.parse_args()
+
+    with serial.Serial(args.port, timeout=1) as port:
+        command(port, "usb_stats reset")
+        print(command(port, "stream %d 16" % args.rate).strip())
+
+        data = frames(args.kbytes)
+        start = time.monotonic()
+        port.write(data)
+        port.flush()
+        elapsed = time.monotonic() - start
+
+        # Extra 0xFF after the last frame leaves stream mode
+        port.write(FRAME_END)
+        time.sleep(0.2)
+
+        print("host: %d bytes in %.3f s (%.0f bytes/s)" % (len(data), elapsed, len(data) / elapsed))
+        print(command(port, "usb_stats").strip())
+        print(command(port, "stream stats").strip())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,19 @@
+#ifndef APP_ERROR_H
+#define APP_ERROR_H
+
+#include "sdk_errors.h"
+
+// Ошибка в симуляторе: сообщение и аварийное завершение процесса
+void app_error_handler(ret_code_t error_code, uint32_t line_num, const char * p_file_name);
+
+#define APP_ERROR_CHECK(ERR_CODE)                                       \
+    do                                                                  \
+    {                                                                   \
+        const ret_code_t LOCAL_ERR_CODE = (ERR_CODE);                   \
+        if (LOCAL_ERR_CODE != NRF_SUCCESS)                              \
+        {                                                               \
+            app_error_handler(LOCAL_ERR_CODE, __LINE__, __FILE__);      \
+        }                                                               \
+    } while (0)
+
+#endif
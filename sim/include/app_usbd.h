@@ -0,0 +1,40 @@
+#ifndef APP_USBD_H
+#define APP_USBD_H
+
+#include "sdk_common.h"
+#include "app_usbd_class_base.h"
+
+// Стек USB без устройства: события питания не приходят, добавленный класс
+// CDC ACM сразу получает псевдотерминал (sim_cdc_acm.c)
+
+typedef enum
+{
+    APP_USBD_EVT_DRV_SOF,
+    APP_USBD_EVT_DRV_RESET,
+    APP_USBD_EVT_DRV_SUSPEND,
+    APP_USBD_EVT_DRV_RESUME,
+    APP_USBD_EVT_STARTED,
+    APP_USBD_EVT_STOPPED,
+    APP_USBD_EVT_POWER_DETECTED,
+    APP_USBD_EVT_POWER_REMOVED,
+    APP_USBD_EVT_POWER_READY
+} app_usbd_event_type_t;
+
+typedef void (*app_usbd_event_handler_t)(app_usbd_event_type_t event);
+
+typedef struct
+{
+    app_usbd_event_handler_t ev_state_proc;
+} app_usbd_config_t;
+
+static inline ret_code_t app_usbd_init(app_usbd_config_t const * p_config) { (void)p_config; return NRF_SUCCESS; }
+ret_code_t app_usbd_class_append(app_usbd_class_inst_t const * p_inst);
+
+static inline ret_code_t app_usbd_power_events_enable(void) { return NRF_SUCCESS; }
+static inline void app_usbd_enable(void)  { }
+static inline void app_usbd_disable(void) { }
+static inline void app_usbd_start(void)   { }
+static inline void app_usbd_stop(void)    { }
+static inline bool nrf_drv_usbd_is_enabled(void) { return true; }
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef APP_USBD_CDC_ACM_H
+#define APP_USBD_CDC_ACM_H
+
+#include "sdk_common.h"
+#include "app_usbd_class_base.h"
+
+// Класс CDC ACM поверх псевдотерминала хоста (sim_cdc_acm.c). Порт открыт,
+// пока открыта подчиненная сторона pty. События класса вызываются из
+// nrf_pwr_mgmt_run(), TX_DONE - сразу после записи всех данных в pty
+
+typedef enum
+{
+    APP_USBD_CDC_ACM_USER_EVT_RX_DONE,
+    APP_USBD_CDC_ACM_USER_EVT_TX_DONE,
+    APP_USBD_CDC_ACM_USER_EVT_PORT_OPEN,
+    APP_USBD_CDC_ACM_USER_EVT_PORT_CLOSE
+} app_usbd_cdc_acm_user_event_t;
+
+typedef enum
+{
+    APP_USBD_CDC_COMM_PROTOCOL_NONE     = 0x00,
+    APP_USBD_CDC_COMM_PROTOCOL_AT_V250  = 0x01
+} app_usbd_cdc_comm_protocol_t;
+
+typedef void (*app_usbd_cdc_acm_user_ev_handler_t)(app_usbd_class_inst_t const * p_inst,
+                                                   app_usbd_cdc_acm_user_event_t event);
+
+typedef struct
+{
+    app_usbd_class_inst_t              base;
+    app_usbd_cdc_acm_user_ev_handler_t user_ev_handler;
+} app_usbd_cdc_acm_t;
+
+// Номера интерфейсов и конечных точек в симуляторе не используются
+#define APP_USBD_CDC_ACM_GLOBAL_DEF(instance_name, user_event_handler, comm_ifc, data_ifc,  \
+                                    comm_ein, data_ein, data_eout, cdc_protocol)            \
+    static const app_usbd_cdc_acm_t instance_name =                                         \
+    {                                                                                       \
+        .base            = { .p_name = #instance_name },                                    \
+        .user_ev_handler = (user_event_handler)                                             \
+    }
+
+static inline app_usbd_class_inst_t const * app_usbd_cdc_acm_class_inst_get(app_usbd_cdc_acm_t const * p_cdc_acm)
+{
+    return &p_cdc_acm->base;
+}
+
+ret_code_t app_usbd_cdc_acm_read_any(app_usbd_cdc_acm_t const * p_cdc_acm, void * p_buf, size_t length);
+size_t app_usbd_cdc_acm_rx_size(app_usbd_cdc_acm_t const * p_cdc_acm);
+ret_code_t app_usbd_cdc_acm_write(app_usbd_cdc_acm_t const * p_cdc_acm, void const * p_buf, size_t length);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef APP_USBD_CLASS_BASE_H
+#define APP_USBD_CLASS_BASE_H
+
+// Экземпляр класса USB: в симуляторе порт CDC ACM - псевдотерминал (sim_usb_cdc.c)
+
+typedef struct
+{
+    char const * p_name;
+} app_usbd_class_inst_t;
+
+#endif
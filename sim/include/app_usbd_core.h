@@ -0,0 +1,6 @@
+#ifndef APP_USBD_CORE_H
+#define APP_USBD_CORE_H
+
+#include "app_usbd.h"
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef APP_USBD_SERIAL_NUM_H
+#define APP_USBD_SERIAL_NUM_H
+
+static inline void app_usbd_serial_num_generate(void) { }
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef APP_UTIL_PLATFORM_H
+#define APP_UTIL_PLATFORM_H
+
+#include "sdk_common.h"
+#include "nrf.h"
+
+// Обработчики "прерываний" симулятора вызываются только из nrf_pwr_mgmt_run(),
+// поэтому критическая секция сводится к области видимости
+#define CRITICAL_REGION_ENTER() {
+#define CRITICAL_REGION_EXIT()  }
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef NRF_H
+#define NRF_H
+
+#include <stdint.h>
+
+// Встроенные функции CMSIS, которые используют модули приложения
+
+#define __DMB()     __sync_synchronize()
+#define __DSB()     __sync_synchronize()
+#define __ISB()     __sync_synchronize()
+#define __WFE()
+#define __CLZ(x)    ((uint8_t)((x) ? __builtin_clz(x) : 32))
+
+#endif
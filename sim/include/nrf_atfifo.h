@@ -0,0 +1,67 @@
+#ifndef NRF_ATFIFO_H
+#define NRF_ATFIFO_H
+
+#include <string.h>
+#include "sdk_common.h"
+
+// Очередь из nrf_atfifo: прерывания симулятора выполняются в основном
+// потоке, поэтому достаточно простого кольца без атомарных операций
+
+typedef struct
+{
+    void *   p_buf;
+    uint16_t item_size;
+    uint16_t buf_size;      // Байт, на один элемент больше емкости
+    uint16_t head;          // Смещение чтения
+    uint16_t tail;          // Смещение записи
+} nrf_atfifo_t;
+
+typedef struct { uint16_t offset; } nrf_atfifo_item_get_t;
+typedef struct { uint16_t offset; } nrf_atfifo_item_put_t;
+
+#define NRF_ATFIFO_DEF(fifo_id, storage_type, item_cnt)                             \
+    static storage_type CONCAT_2(fifo_id, _data)[(item_cnt) + 1];                   \
+    static nrf_atfifo_t CONCAT_2(fifo_id, _inst);                                   \
+    static nrf_atfifo_t * const fifo_id = &CONCAT_2(fifo_id, _inst)
+
+#define NRF_ATFIFO_INIT(fifo_id)                                                    \
+    nrf_atfifo_init(fifo_id, CONCAT_2(fifo_id, _data),                              \
+                    sizeof(CONCAT_2(fifo_id, _data)), sizeof(CONCAT_2(fifo_id, _data)[0]))
+
+static inline ret_code_t nrf_atfifo_init(nrf_atfifo_t * const p_fifo, void * p_buf,
+                                         uint16_t buf_size, uint16_t item_size)
+{
+    p_fifo->p_buf     = p_buf;
+    p_fifo->item_size = item_size;
+    p_fifo->buf_size  = buf_size;
+    p_fifo->head      = 0;
+    p_fifo->tail      = 0;
+    return NRF_SUCCESS;
+}
+
+static inline ret_code_t nrf_atfifo_alloc_put(nrf_atfifo_t * const p_fifo, void const * p_var,
+                                              size_t size, bool * const p_visible)
+{
+    uint16_t next = p_fifo->tail + p_fifo->item_size;
+    if (next >= p_fifo->buf_size) next = 0;
+    if (next == p_fifo->head) return NRF_ERROR_NO_MEM;
+
+    memcpy((uint8_t *)p_fifo->p_buf + p_fifo->tail, p_var, size);
+    p_fifo->tail = next;
+    if (p_visible != NULL) *p_visible = true;
+    return NRF_SUCCESS;
+}
+
+static inline ret_code_t nrf_atfifo_get_free(nrf_atfifo_t * const p_fifo, void * const p_var,
+                                             size_t size, bool * p_released)
+{
+    if (p_fifo->head == p_fifo->tail) return NRF_ERROR_NOT_FOUND;
+
+    memcpy(p_var, (uint8_t *)p_fifo->p_buf + p_fifo->head, size);
+    p_fifo->head += p_fifo->item_size;
+    if (p_fifo->head >= p_fifo->buf_size) p_fifo->head = 0;
+    if (p_released != NULL) *p_released = true;
+    return NRF_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef NRF_CLI_H
+#define NRF_CLI_H
+
+#include "sdk_common.h"
+
+// Только типы nrf_cli, нужные транспорту и обработчикам команд: симулятор
+// собирается с компактным CLI (cli_compact.c), без самой библиотеки
+
+typedef enum
+{
+    NRF_CLI_DEFAULT,
+    NRF_CLI_NORMAL,
+    NRF_CLI_INFO,
+    NRF_CLI_OPTION,
+    NRF_CLI_WARNING,
+    NRF_CLI_ERROR
+} nrf_cli_vt100_color_t;
+
+typedef enum
+{
+    NRF_CLI_TRANSPORT_EVT_RX_RDY,
+    NRF_CLI_TRANSPORT_EVT_TX_RDY
+} nrf_cli_transport_evt_t;
+
+typedef void (*nrf_cli_transport_handler_t)(nrf_cli_transport_evt_t event, void * p_context);
+
+typedef struct nrf_cli_transport_s nrf_cli_transport_t;
+
+typedef struct
+{
+    ret_code_t (*init)(nrf_cli_transport_t const * p_transport, void const * p_config,
+                       nrf_cli_transport_handler_t evt_handler, void * p_context);
+    ret_code_t (*uninit)(nrf_cli_transport_t const * p_transport);
+    ret_code_t (*enable)(nrf_cli_transport_t const * p_transport, bool blocking);
+    ret_code_t (*write)(nrf_cli_transport_t const * p_transport, const void * p_data,
+                        size_t length, size_t * p_cnt);
+    ret_code_t (*read)(nrf_cli_transport_t const * p_transport, void * p_data,
+                       size_t length, size_t * p_cnt);
+} nrf_cli_transport_api_t;
+
+struct nrf_cli_transport_s
+{
+    nrf_cli_transport_api_t const * p_api;
+};
+
+typedef struct
+{
+    char const * p_name;
+} nrf_cli_t;
+
+typedef void (*nrf_cli_cmd_handler)(nrf_cli_t const * p_cli, size_t argc, char ** argv);
+
+void nrf_cli_fprintf(nrf_cli_t const * p_cli, nrf_cli_vt100_color_t color, char const * p_fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef NRF_DELAY_H
+#define NRF_DELAY_H
+
+#include <stdint.h>
+
+// Задержки нужны только для установления уровней на выводах
+static inline void nrf_delay_us(uint32_t us_time) { (void)us_time; }
+static inline void nrf_delay_ms(uint32_t ms_time) { (void)ms_time; }
+
+#endif
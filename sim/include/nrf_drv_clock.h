@@ -0,0 +1,13 @@
+#ifndef NRF_DRV_CLOCK_H
+#define NRF_DRV_CLOCK_H
+
+#include "sdk_errors.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Тактирование на хосте не нужно: LFCLK "запущен" сразу
+static inline ret_code_t nrf_drv_clock_init(void) { return NRF_SUCCESS; }
+static inline void nrf_drv_clock_lfclk_request(void const * p_handler_item) { (void)p_handler_item; }
+static inline bool nrf_drv_clock_lfclk_is_running(void) { return true; }
+
+#endif
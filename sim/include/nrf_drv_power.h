@@ -0,0 +1,8 @@
+#ifndef NRF_DRV_POWER_H
+#define NRF_DRV_POWER_H
+
+#include "sdk_errors.h"
+
+static inline ret_code_t nrf_drv_power_init(void const * p_config) { (void)p_config; return NRF_SUCCESS; }
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef NRF_FPRINTF_H
+#define NRF_FPRINTF_H
+
+#include <stdarg.h>
+#include "sdk_common.h"
+
+// nrf_fprintf поверх vsnprintf (sim_sdk.c). Как в SDK: вывод копится в
+// буфере контекста, при заполнении и в конце вызова уходит в fwrite
+
+typedef void (* nrf_fprintf_fwrite)(void const * p_user_ctx, char const * p_str, size_t length);
+
+typedef struct nrf_fprintf_ctx
+{
+    char * const             p_io_buffer;
+    size_t const             io_buffer_size;
+    size_t                   io_buffer_cnt;
+    bool                     auto_flush;
+    void const * const       p_user_ctx;
+    nrf_fprintf_fwrite       fwrite;
+} nrf_fprintf_ctx_t;
+
+#define NRF_FPRINTF_DEF(name, p_user_context, p_flush_buffer, flush_buffer_size, flush_when_full, fwrite_fn) \
+    static nrf_fprintf_ctx_t name =                                                                 \
+    {                                                                                               \
+        .p_io_buffer    = (p_flush_buffer),                                                         \
+        .io_buffer_size = (flush_buffer_size),                                                      \
+        .io_buffer_cnt  = 0,                                                                        \
+        .auto_flush     = (flush_when_full),                                                        \
+        .p_user_ctx     = (p_user_context),                                                         \
+        .fwrite         = (fwrite_fn)                                                               \
+    }
+
+void nrf_fprintf_fmt(nrf_fprintf_ctx_t * const p_ctx, char const * p_fmt, va_list * p_args);
+
+void nrf_fprintf(nrf_fprintf_ctx_t * const p_ctx, char const * p_fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+void nrf_fprintf_buffer_flush(nrf_fprintf_ctx_t * const p_ctx);
+
+#endif
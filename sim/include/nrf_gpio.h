@@ -0,0 +1,21 @@
+#ifndef NRF_GPIO_H
+#define NRF_GPIO_H
+
+#include <stdint.h>
+
+// Выводы без подключенной схемы: входы с подтяжкой читаются как 1
+
+typedef enum
+{
+    NRF_GPIO_PIN_NOPULL   = 0,
+    NRF_GPIO_PIN_PULLDOWN = 1,
+    NRF_GPIO_PIN_PULLUP   = 3
+} nrf_gpio_pin_pull_t;
+
+static inline void nrf_gpio_cfg_output(uint32_t pin_number)  { (void)pin_number; }
+static inline void nrf_gpio_cfg_default(uint32_t pin_number) { (void)pin_number; }
+static inline void nrf_gpio_pin_set(uint32_t pin_number)     { (void)pin_number; }
+static inline void nrf_gpio_pin_clear(uint32_t pin_number)   { (void)pin_number; }
+static inline uint32_t nrf_gpio_pin_read(uint32_t pin_number) { (void)pin_number; return 1; }
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef NRF_LOG_H
+#define NRF_LOG_H
+
+#include <stdio.h>
+
+// Журнал выводится в stderr, отладочные сообщения отбрасываются
+
+#define NRF_LOG_ERROR(...)      NRF_LOG_SIM("error", __VA_ARGS__)
+#define NRF_LOG_WARNING(...)    NRF_LOG_SIM("warning", __VA_ARGS__)
+#define NRF_LOG_INFO(...)       NRF_LOG_SIM("info", __VA_ARGS__)
+#define NRF_LOG_DEBUG(...)
+#define NRF_LOG_FLUSH()
+
+#define NRF_LOG_SIM(level, ...)                         \
+    do                                                  \
+    {                                                   \
+        fprintf(stderr, "<%s> ", level);                \
+        fprintf(stderr, __VA_ARGS__);                   \
+        fputc('\n', stderr);                            \
+    } while (0)
+
+#endif
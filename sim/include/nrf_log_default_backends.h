@@ -0,0 +1,6 @@
+#ifndef NRF_LOG_DEFAULT_BACKENDS_H
+#define NRF_LOG_DEFAULT_BACKENDS_H
+
+#define NRF_LOG_DEFAULT_BACKENDS_INIT()
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef NRF_PWM_H
+#define NRF_PWM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Типы HAL ШИМ; "регистры" - состояние прерываний экземпляра в sim_pwm.c
+
+#define NRF_PWM_PIN_NOT_CONNECTED   0xFFFFFFFF
+#define NRF_PWM_CHANNEL_COUNT       4
+
+typedef struct
+{
+    uint32_t inten;
+} NRF_PWM_Type;
+
+typedef enum
+{
+    NRF_PWM_CLK_16MHz,
+    NRF_PWM_CLK_8MHz,
+    NRF_PWM_CLK_4MHz,
+    NRF_PWM_CLK_2MHz,
+    NRF_PWM_CLK_1MHz,
+    NRF_PWM_CLK_500kHz,
+    NRF_PWM_CLK_250kHz,
+    NRF_PWM_CLK_125kHz
+} nrf_pwm_clk_t;
+
+typedef enum
+{
+    NRF_PWM_MODE_UP,
+    NRF_PWM_MODE_UP_AND_DOWN
+} nrf_pwm_mode_t;
+
+typedef enum
+{
+    NRF_PWM_LOAD_COMMON,
+    NRF_PWM_LOAD_GROUPED,
+    NRF_PWM_LOAD_INDIVIDUAL,
+    NRF_PWM_LOAD_WAVE_FORM
+} nrf_pwm_dec_load_t;
+
+typedef enum
+{
+    NRF_PWM_STEP_AUTO,
+    NRF_PWM_STEP_TRIGGERED
+} nrf_pwm_dec_step_t;
+
+typedef enum
+{
+    NRF_PWM_EVENT_STOPPED,
+    NRF_PWM_EVENT_SEQEND0,
+    NRF_PWM_EVENT_SEQEND1,
+    NRF_PWM_EVENT_PWMPERIODEND,
+    NRF_PWM_EVENT_LOOPSDONE
+} nrf_pwm_event_t;
+
+#define NRF_PWM_INT_SEQEND0_MASK    (1UL << 4)
+
+typedef uint16_t nrf_pwm_values_common_t;
+
+typedef struct
+{
+    uint16_t channel_0;
+    uint16_t channel_1;
+    uint16_t channel_2;
+    uint16_t channel_3;
+} nrf_pwm_values_individual_t;
+
+typedef union
+{
+    nrf_pwm_values_common_t const *     p_common;
+    nrf_pwm_values_individual_t const * p_individual;
+    uint16_t const *                    p_raw;
+} nrf_pwm_values_t;
+
+typedef struct
+{
+    nrf_pwm_values_t values;
+    uint16_t         length;
+    uint32_t         repeats;
+    uint32_t         end_delay;
+} nrf_pwm_sequence_t;
+
+static inline void nrf_pwm_int_enable(NRF_PWM_Type * p_reg, uint32_t mask)  { p_reg->inten |= mask; }
+static inline void nrf_pwm_int_disable(NRF_PWM_Type * p_reg, uint32_t mask) { p_reg->inten &= ~mask; }
+static inline void nrf_pwm_event_clear(NRF_PWM_Type * p_reg, nrf_pwm_event_t event) { (void)p_reg; (void)event; }
+
+#endif
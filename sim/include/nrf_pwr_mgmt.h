@@ -0,0 +1,11 @@
+#ifndef NRF_PWR_MGMT_H
+#define NRF_PWR_MGMT_H
+
+#include "sdk_errors.h"
+
+static inline ret_code_t nrf_pwr_mgmt_init(void) { return NRF_SUCCESS; }
+
+// Ожидание событий симулятора: таймеров и pty (sim_loop.c)
+void nrf_pwr_mgmt_run(void);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef NRFX_GPIOTE_H
+#define NRFX_GPIOTE_H
+
+#include "sdk_common.h"
+#include "nrf_gpio.h"
+
+// Входы GPIOTE (sim_gpio.c): уровень вывода хранится в симуляторе,
+// обработчик вызывается из nrf_pwr_mgmt_run() при его изменении
+
+typedef uint32_t nrfx_gpiote_pin_t;
+
+typedef enum
+{
+    NRF_GPIOTE_POLARITY_LOTOHI = 1,
+    NRF_GPIOTE_POLARITY_HITOLO = 2,
+    NRF_GPIOTE_POLARITY_TOGGLE = 3
+} nrf_gpiote_polarity_t;
+
+typedef struct
+{
+    nrf_gpiote_polarity_t sense;
+    nrf_gpio_pin_pull_t   pull;
+    bool                  is_watcher;
+    bool                  hi_accuracy;
+    bool                  skip_gpio_setup;
+} nrfx_gpiote_in_config_t;
+
+#define NRFX_GPIOTE_CONFIG_IN_SENSE_TOGGLE(hi_accu)     \
+{                                                       \
+    .sense       = NRF_GPIOTE_POLARITY_TOGGLE,          \
+    .pull        = NRF_GPIO_PIN_NOPULL,                 \
+    .is_watcher  = false,                               \
+    .hi_accuracy = (hi_accu),                           \
+}
+
+#define NRFX_GPIOTE_CONFIG_IN_SENSE_HITOLO(hi_accu)     \
+{                                                       \
+    .sense       = NRF_GPIOTE_POLARITY_HITOLO,          \
+    .pull        = NRF_GPIO_PIN_NOPULL,                 \
+    .is_watcher  = false,                               \
+    .hi_accuracy = (hi_accu),                           \
+}
+
+typedef void (*nrfx_gpiote_evt_handler_t)(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action);
+
+ret_code_t nrfx_gpiote_init(void);
+bool nrfx_gpiote_is_init(void);
+ret_code_t nrfx_gpiote_in_init(nrfx_gpiote_pin_t pin, nrfx_gpiote_in_config_t const * p_config,
+                               nrfx_gpiote_evt_handler_t evt_handler);
+bool nrfx_gpiote_in_is_set(nrfx_gpiote_pin_t pin);
+void nrfx_gpiote_in_event_enable(nrfx_gpiote_pin_t pin, bool int_enable);
+void nrfx_gpiote_in_event_disable(nrfx_gpiote_pin_t pin);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef NRFX_NVMC_H
+#define NRFX_NVMC_H
+
+#include "sdk_common.h"
+
+// Flash - файл (ESTC_SIM_FLASH), отображенный по адресам nRF52840
+// (sim_flash.c). Запись, как у NVMC, только сбрасывает биты
+
+ret_code_t nrfx_nvmc_page_erase(uint32_t address);
+void nrfx_nvmc_words_write(uint32_t address, void const * src, uint32_t num_words);
+bool nrfx_nvmc_write_done_check(void);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef NRFX_PWM_H
+#define NRFX_PWM_H
+
+#include "sdk_common.h"
+#include "nrf_pwm.h"
+
+// ШИМ без выходов: sim_pwm.c записывает скважности каналов при каждом
+// изменении в файл (ESTC_SIM_PWM_LOG)
+
+#define NRFX_PWM_INSTANCE_COUNT     4
+
+extern NRF_PWM_Type nrfx_pwm_sim_regs[NRFX_PWM_INSTANCE_COUNT];
+
+typedef struct
+{
+    NRF_PWM_Type * p_registers;
+    uint8_t        drv_inst_idx;
+} nrfx_pwm_t;
+
+#define NRFX_PWM_INSTANCE(id)   { .p_registers = &nrfx_pwm_sim_regs[id], .drv_inst_idx = (id) }
+
+#define NRFX_PWM_PIN_NOT_USED   0xFF
+#define NRFX_PWM_PIN_INVERTED   0x80
+
+typedef struct
+{
+    uint8_t            output_pins[NRF_PWM_CHANNEL_COUNT];
+    uint8_t            irq_priority;
+    nrf_pwm_clk_t      base_clock;
+    nrf_pwm_mode_t     count_mode;
+    uint16_t           top_value;
+    nrf_pwm_dec_load_t load_mode;
+    nrf_pwm_dec_step_t step_mode;
+} nrfx_pwm_config_t;
+
+#define NRFX_PWM_DEFAULT_CONFIG                                                         \
+{                                                                                       \
+    .output_pins  = { NRFX_PWM_PIN_NOT_USED, NRFX_PWM_PIN_NOT_USED,                     \
+                      NRFX_PWM_PIN_NOT_USED, NRFX_PWM_PIN_NOT_USED },                   \
+    .irq_priority = 6,                                                                  \
+    .base_clock   = NRF_PWM_CLK_1MHz,                                                   \
+    .count_mode   = NRF_PWM_MODE_UP,                                                    \
+    .top_value    = 1000,                                                               \
+    .load_mode    = NRF_PWM_LOAD_COMMON,                                                \
+    .step_mode    = NRF_PWM_STEP_AUTO                                                   \
+}
+
+typedef enum
+{
+    NRFX_PWM_FLAG_STOP            = 0x01,
+    NRFX_PWM_FLAG_LOOP            = 0x02,
+    NRFX_PWM_FLAG_SIGNAL_END_SEQ0 = 0x04,
+    NRFX_PWM_FLAG_SIGNAL_END_SEQ1 = 0x08,
+    NRFX_PWM_FLAG_NO_EVT_FINISHED = 0x10
+} nrfx_pwm_flag_t;
+
+typedef enum
+{
+    NRFX_PWM_EVT_FINISHED,
+    NRFX_PWM_EVT_END_SEQ0,
+    NRFX_PWM_EVT_END_SEQ1,
+    NRFX_PWM_EVT_STOPPED
+} nrfx_pwm_evt_type_t;
+
+typedef void (*nrfx_pwm_handler_t)(nrfx_pwm_evt_type_t event_type);
+
+ret_code_t nrfx_pwm_init(nrfx_pwm_t const * p_instance, nrfx_pwm_config_t const * p_config,
+                         nrfx_pwm_handler_t handler);
+uint32_t nrfx_pwm_simple_playback(nrfx_pwm_t const * p_instance, nrf_pwm_sequence_t const * p_sequence,
+                                  uint16_t playback_count, uint32_t flags);
+bool nrfx_pwm_stop(nrfx_pwm_t const * p_instance, bool wait_until_stopped);
+bool nrfx_pwm_is_stopped(nrfx_pwm_t const * p_instance);
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef NRFX_TIMER_H
+#define NRFX_TIMER_H
+
+#include "sdk_common.h"
+#include "nrf.h"
+
+// Таймеры TIMER0-TIMER4 на часах хоста (sim_timer.c): счет, сравнение с
+// прерыванием и короткие связи COMPARE->CLEAR/STOP. Захват по PPI не
+// поддерживается
+
+typedef enum
+{
+    NRF_TIMER_FREQ_16MHz = 0,
+    NRF_TIMER_FREQ_8MHz,
+    NRF_TIMER_FREQ_4MHz,
+    NRF_TIMER_FREQ_2MHz,
+    NRF_TIMER_FREQ_1MHz,
+    NRF_TIMER_FREQ_500kHz,
+    NRF_TIMER_FREQ_250kHz,
+    NRF_TIMER_FREQ_125kHz,
+    NRF_TIMER_FREQ_62500Hz,
+    NRF_TIMER_FREQ_31250Hz
+} nrf_timer_frequency_t;
+
+typedef enum
+{
+    NRF_TIMER_MODE_TIMER,
+    NRF_TIMER_MODE_COUNTER,
+    NRF_TIMER_MODE_LOW_POWER_COUNTER
+} nrf_timer_mode_t;
+
+typedef enum
+{
+    NRF_TIMER_BIT_WIDTH_16,
+    NRF_TIMER_BIT_WIDTH_8,
+    NRF_TIMER_BIT_WIDTH_24,
+    NRF_TIMER_BIT_WIDTH_32
+} nrf_timer_bit_width_t;
+
+typedef enum
+{
+    NRF_TIMER_CC_CHANNEL0,
+    NRF_TIMER_CC_CHANNEL1,
+    NRF_TIMER_CC_CHANNEL2,
+    NRF_TIMER_CC_CHANNEL3,
+    NRF_TIMER_CC_CHANNEL4,
+    NRF_TIMER_CC_CHANNEL5
+} nrf_timer_cc_channel_t;
+
+#define NRF_TIMER_CC_COUNT  6
+
+typedef enum
+{
+    NRF_TIMER_EVENT_COMPARE0,
+    NRF_TIMER_EVENT_COMPARE1,
+    NRF_TIMER_EVENT_COMPARE2,
+    NRF_TIMER_EVENT_COMPARE3,
+    NRF_TIMER_EVENT_COMPARE4,
+    NRF_TIMER_EVENT_COMPARE5
+} nrf_timer_event_t;
+
+// Биты как в регистре SHORTS
+#define NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK     (1UL << 0)
+#define NRF_TIMER_SHORT_COMPARE0_STOP_MASK      (1UL << 8)
+
+typedef void (*nrfx_timer_event_handler_t)(nrf_timer_event_t event_type, void * p_context);
+
+typedef struct
+{
+    uint8_t instance_id;
+    uint8_t cc_channel_count;
+} nrfx_timer_t;
+
+#define NRFX_TIMER_INSTANCE(id)     { .instance_id = (id), .cc_channel_count = NRF_TIMER_CC_COUNT }
+
+typedef struct
+{
+    nrf_timer_frequency_t frequency;
+    nrf_timer_mode_t      mode;
+    nrf_timer_bit_width_t bit_width;
+    uint8_t               interrupt_priority;
+    void *                p_context;
+} nrfx_timer_config_t;
+
+#define NRFX_TIMER_DEFAULT_CONFIG                   \
+{                                                   \
+    .frequency          = NRF_TIMER_FREQ_16MHz,     \
+    .mode               = NRF_TIMER_MODE_TIMER,     \
+    .bit_width          = NRF_TIMER_BIT_WIDTH_16,   \
+    .interrupt_priority = 6,                        \
+    .p_context          = NULL                      \
+}
+
+ret_code_t nrfx_timer_init(nrfx_timer_t const * p_instance, nrfx_timer_config_t const * p_config,
+                           nrfx_timer_event_handler_t timer_event_handler);
+void nrfx_timer_enable(nrfx_timer_t const * p_instance);
+void nrfx_timer_disable(nrfx_timer_t const * p_instance);
+void nrfx_timer_clear(nrfx_timer_t const * p_instance);
+void nrfx_timer_extended_compare(nrfx_timer_t const * p_instance, nrf_timer_cc_channel_t cc_channel,
+                                 uint32_t cc_value, uint32_t timer_short_mask, bool enable_int);
+uint32_t nrfx_timer_us_to_ticks(nrfx_timer_t const * p_instance, uint32_t time_us);
+
+#endif
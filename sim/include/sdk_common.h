@@ -0,0 +1,22 @@
+#ifndef SDK_COMMON_H
+#define SDK_COMMON_H
+
+// Общие макросы SDK (nordic_common.h, app_util.h) для сборки на хосте
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "sdk_config.h"
+#include "sdk_errors.h"
+#include "app_error.h"
+
+#define MIN(a, b)               ((a) < (b) ? (a) : (b))
+#define MAX(a, b)               ((a) < (b) ? (b) : (a))
+#define ARRAY_SIZE(arr)         (sizeof(arr) / sizeof((arr)[0]))
+#define UNUSED_PARAMETER(X)     (void)(X)
+
+#define CONCAT_2(p1, p2)        CONCAT_2_(p1, p2)
+#define CONCAT_2_(p1, p2)       p1##p2
+
+#endif
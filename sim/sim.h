@@ -0,0 +1,59 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <poll.h>
+#include <signal.h>
+
+// Внутренний интерфейс симулятора между моделью периферии и циклом
+// ожидания nrf_pwr_mgmt_run() (sim_loop.c).
+//
+// Прерывания моделируются вызовом обработчиков из nrf_pwr_mgmt_run(),
+// то есть только в точке сна основного цикла. Исключение - TX_DONE CDC ACM:
+// он приходит прямо из записи, иначе циклы ожидания передатчика в основном
+// цикле не завершились бы.
+
+// Нет запланированных событий
+#define SIM_TIME_NEVER  UINT64_MAX
+
+// Монотонное время с запуска, мкс
+uint64_t sim_time_us(void);
+
+// Событие прерывания вне nrf_pwr_mgmt_run(): следующий вызов не засыпает (как регистр событий WFE)
+void sim_wake(void);
+
+// Таймеры app_timer и TIMERn: время ближайшего срабатывания и вызов обработчиков
+uint64_t sim_timer_next_us(void);
+void sim_timer_process(void);
+
+// pty CDC ACM: дескриптор и ожидаемые события для poll(), обработка результата
+void sim_cdc_acm_pollfd(struct pollfd * p_pollfd);
+// Закрытый порт в poll() не участвует: открытие проверяется при каждом вызове
+void sim_cdc_acm_process(short revents);
+
+// ШИМ: запись изменений каналов и отложенные события
+bool sim_pwm_pending(void);
+void sim_pwm_process(void);
+
+// Кнопка по сигналам SIGUSR1 (нажата) и SIGUSR2 (отпущена)
+void sim_gpio_signals_init(sigset_t * p_wait_mask);
+void sim_gpio_process(void);
+
+// Для тестов (sim/test): уровень входа GPIOTE с вызовом обработчика, как от фронта
+void sim_gpio_set(uint32_t pin, bool level);
+
+// Для тестов: значения каналов на выходе экземпляра ШИМ, остановленный - нули
+void sim_pwm_output(uint32_t index, uint16_t p_values[4]);
+
+// Для тестов: выводимая последовательность экземпляра (false - ШИМ остановлен)
+bool sim_pwm_sequence(uint32_t index, uint16_t const ** pp_values, uint32_t * p_length);
+
+// Для тестов: сторона хоста pty (неблокирующая), порт открывается в следующем проходе цикла
+int sim_cdc_acm_host_open(void);
+
+// Для тестов: запущенный прием завершается пакетом нулевой длины (ZLP),
+// который через pty не передать. false - порт закрыт или прием не запущен
+bool sim_cdc_acm_rx_zlp(void);
+
+#endif
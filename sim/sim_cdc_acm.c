@@ -0,0 +1,188 @@
+#define _GNU_SOURCE
+#include "sim.h"
+#include "app_usbd.h"
+#include "app_usbd_cdc_acm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <termios.h>
+
+// Ожидание хоста, не читающего pty, после - данные передачи отбрасываются
+#define TX_TIMEOUT_MS   1000
+
+static app_usbd_cdc_acm_t const * m_p_cdc_acm;
+static int                        m_fd = -1;     // Сторона master pty
+static bool                       m_port_open = false;
+
+// Запущенный прием: буфер класса, куда read() положит следующий пакет
+static uint8_t *                  m_p_rx_buf;
+static size_t                     m_rx_buf_len;
+static size_t                     m_rx_size;
+
+static void cdc_acm_event(app_usbd_cdc_acm_user_event_t event)
+{
+    m_p_cdc_acm->user_ev_handler(&m_p_cdc_acm->base, event);
+}
+
+// Псевдотерминал вместо перечисления USB. Подчиненная сторона переводится
+// в raw один раз и закрывается: порт "открыт", пока ее держит хост
+static void pty_open(void)
+{
+    m_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((m_fd < 0) || (grantpt(m_fd) != 0) || (unlockpt(m_fd) != 0))
+    {
+        perror("pty");
+        exit(EXIT_FAILURE);
+    }
+    fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+
+    const char * p_name = ptsname(m_fd);
+    int slave = open(p_name, O_RDWR | O_NOCTTY);
+    if (slave >= 0)
+    {
+        struct termios tio;
+        tcgetattr(slave, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(slave, TCSANOW, &tio);
+        close(slave);
+    }
+
+    // Постоянное имя для скриптов
+    const char * p_link = getenv("ESTC_SIM_PTY");
+    if (p_link != NULL)
+    {
+        unlink(p_link);
+        if (symlink(p_name, p_link) != 0) perror(p_link);
+    }
+
+    printf("usb_cdc: %s\n", (p_link != NULL) ? p_link : p_name);
+    fflush(stdout);
+}
+
+ret_code_t app_usbd_class_append(app_usbd_class_inst_t const * p_inst)
+{
+    if ((p_inst == NULL) || (m_p_cdc_acm != NULL)) return NRF_ERROR_INVALID_STATE;
+
+    // Единственный класс - CDC ACM, base его первое поле
+    m_p_cdc_acm = (app_usbd_cdc_acm_t const *)p_inst;
+    pty_open();
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_usbd_cdc_acm_read_any(app_usbd_cdc_acm_t const * p_cdc_acm, void * p_buf, size_t length)
+{
+    if (m_p_rx_buf != NULL) return NRF_ERROR_BUSY;
+
+    m_p_rx_buf   = p_buf;
+    m_rx_buf_len = length;
+    return NRF_ERROR_IO_PENDING;
+}
+
+size_t app_usbd_cdc_acm_rx_size(app_usbd_cdc_acm_t const * p_cdc_acm)
+{
+    return m_rx_size;
+}
+
+// Порт закрыт хостом: передача отменяется
+static void port_close(void)
+{
+    m_port_open = false;
+    cdc_acm_event(APP_USBD_CDC_ACM_USER_EVT_PORT_CLOSE);
+}
+
+// Запись пакета целиком. Если хост не успевает читать, ждем, как ждал бы
+// конечную точку IN
+static bool pty_write_all(uint8_t const * p_data, size_t length)
+{
+    while (length != 0)
+    {
+        ssize_t cnt = write(m_fd, p_data, length);
+        if (cnt > 0)
+        {
+            p_data += cnt;
+            length -= (size_t)cnt;
+            continue;
+        }
+        if ((cnt < 0) && (errno != EAGAIN) && (errno != EINTR)) return false;
+
+        struct pollfd pfd = { .fd = m_fd, .events = POLLOUT };
+        if ((poll(&pfd, 1, TX_TIMEOUT_MS) <= 0) || (pfd.revents & (POLLHUP | POLLERR))) return false;
+    }
+    return true;
+}
+
+ret_code_t app_usbd_cdc_acm_write(app_usbd_cdc_acm_t const * p_cdc_acm, void const * p_buf, size_t length)
+{
+    if (!m_port_open) return NRF_ERROR_INVALID_STATE;
+
+    if (!pty_write_all(p_buf, length))
+    {
+        port_close();
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    // Пакет передан: TX_DONE до возврата, как от прерывания во время записи
+    cdc_acm_event(APP_USBD_CDC_ACM_USER_EVT_TX_DONE);
+    sim_wake();
+    return NRF_SUCCESS;
+}
+
+void sim_cdc_acm_pollfd(struct pollfd * p_pollfd)
+{
+    // Закрытый порт дал бы POLLHUP сразу; прием ждет свободного буфера
+    p_pollfd->fd      = (m_port_open && (m_p_rx_buf != NULL)) ? m_fd : -1;
+    p_pollfd->events  = POLLIN;
+    p_pollfd->revents = 0;
+}
+
+void sim_cdc_acm_process(short revents)
+{
+    if (m_fd < 0) return;
+
+    if (!m_port_open)
+    {
+        struct pollfd pfd = { .fd = m_fd, .events = POLLIN };
+        poll(&pfd, 1, 0);
+        if (pfd.revents & POLLHUP) return;
+
+        m_port_open = true;
+        cdc_acm_event(APP_USBD_CDC_ACM_USER_EVT_PORT_OPEN);
+        revents = pfd.revents;
+    }
+
+    if (revents & POLLHUP)
+    {
+        port_close();
+        return;
+    }
+    if (!(revents & POLLIN)) return;
+
+    // Каждое чтение - пакет; следующий прием запускает обработчик события
+    while (m_p_rx_buf != NULL)
+    {
+        ssize_t cnt = read(m_fd, m_p_rx_buf, m_rx_buf_len);
+        if (cnt <= 0) return;
+
+        m_rx_size  = (size_t)cnt;
+        m_p_rx_buf = NULL;
+        cdc_acm_event(APP_USBD_CDC_ACM_USER_EVT_RX_DONE);
+    }
+}
+
+int sim_cdc_acm_host_open(void)
+{
+    if (m_fd < 0) return -1;
+    return open(ptsname(m_fd), O_RDWR | O_NOCTTY | O_NONBLOCK);
+}
+
+bool sim_cdc_acm_rx_zlp(void)
+{
+    if (!m_port_open || (m_p_rx_buf == NULL)) return false;
+
+    m_rx_size  = 0;
+    m_p_rx_buf = NULL;
+    cdc_acm_event(APP_USBD_CDC_ACM_USER_EVT_RX_DONE);
+    return true;
+}
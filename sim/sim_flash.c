@@ -0,0 +1,81 @@
+#include "sim.h"
+#include "nrfx_nvmc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Flash nRF52840 - файл того же размера, отображенный по тем же адресам:
+// модули приложения читают настройки прямо по адресу. Первые страницы
+// (ниже vm.mmap_min_addr) не отображаются, приложение их не использует
+#define FLASH_SIZE          0x100000
+#define FLASH_MAP_START     0x10000
+#define FLASH_PAGE_SIZE     0x1000
+
+#define FLASH_FILE_DEFAULT  "sim_flash.bin"
+
+__attribute__((constructor))
+static void sim_flash_init(void)
+{
+    const char * p_path = getenv("ESTC_SIM_FLASH");
+    if (p_path == NULL) p_path = FLASH_FILE_DEFAULT;
+
+    int fd = open(p_path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        perror(p_path);
+        exit(EXIT_FAILURE);
+    }
+
+    // Новый файл - стертая Flash
+    off_t size = lseek(fd, 0, SEEK_END);
+    if (size < FLASH_SIZE)
+    {
+        static uint8_t erased[FLASH_PAGE_SIZE];
+        memset(erased, 0xFF, sizeof(erased));
+        for (off_t offset = size - (size % FLASH_PAGE_SIZE); offset < FLASH_SIZE; offset += FLASH_PAGE_SIZE)
+        {
+            if (pwrite(fd, erased, FLASH_PAGE_SIZE, offset) != FLASH_PAGE_SIZE)
+            {
+                perror(p_path);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    void * p_map = mmap((void *)FLASH_MAP_START, FLASH_SIZE - FLASH_MAP_START, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_FIXED_NOREPLACE, fd, FLASH_MAP_START);
+    if (p_map != (void *)FLASH_MAP_START)
+    {
+        perror("flash mmap");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+}
+
+ret_code_t nrfx_nvmc_page_erase(uint32_t address)
+{
+    if ((address % FLASH_PAGE_SIZE) != 0) return NRF_ERROR_INVALID_ADDR;
+    if ((address < FLASH_MAP_START) || (address >= FLASH_SIZE)) return NRF_ERROR_INVALID_ADDR;
+
+    memset((void *)(uintptr_t)address, 0xFF, FLASH_PAGE_SIZE);
+    return NRF_SUCCESS;
+}
+
+void nrfx_nvmc_words_write(uint32_t address, void const * src, uint32_t num_words)
+{
+    uint32_t *       p_dst = (uint32_t *)(uintptr_t)address;
+    uint32_t const * p_src = src;
+
+    // Программирование только сбрасывает биты в 0
+    for (uint32_t i = 0; i < num_words; i++)
+    {
+        p_dst[i] &= p_src[i];
+    }
+}
+
+bool nrfx_nvmc_write_done_check(void)
+{
+    return true;
+}
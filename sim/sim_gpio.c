@@ -0,0 +1,134 @@
+#include "sim.h"
+#include "nrfx_gpiote.h"
+
+// Входов GPIOTE
+#define GPIOTE_IN_MAX   8
+
+typedef struct
+{
+    nrfx_gpiote_pin_t         pin;
+    nrfx_gpiote_evt_handler_t handler;
+    bool                      level;
+    bool                      event_enabled;
+    bool                      int_enabled;
+} gpiote_in_t;
+
+static gpiote_in_t m_inputs[GPIOTE_IN_MAX];
+static uint32_t    m_input_count;
+static bool        m_gpiote_init = false;
+
+// Уровень кнопки, заданный сигналом: 1 - нажата, 0 - отпущена, -1 - без изменений
+static volatile sig_atomic_t m_button_request = -1;
+
+static gpiote_in_t * input_find(nrfx_gpiote_pin_t pin)
+{
+    for (uint32_t i = 0; i < m_input_count; i++)
+    {
+        if (m_inputs[i].pin == pin) return &m_inputs[i];
+    }
+    return NULL;
+}
+
+ret_code_t nrfx_gpiote_init(void)
+{
+    if (m_gpiote_init) return NRF_ERROR_INVALID_STATE;
+    m_gpiote_init = true;
+    return NRF_SUCCESS;
+}
+
+bool nrfx_gpiote_is_init(void)
+{
+    return m_gpiote_init;
+}
+
+ret_code_t nrfx_gpiote_in_init(nrfx_gpiote_pin_t pin, nrfx_gpiote_in_config_t const * p_config,
+                               nrfx_gpiote_evt_handler_t evt_handler)
+{
+    if (input_find(pin) != NULL) return NRF_ERROR_INVALID_STATE;
+    if (m_input_count == GPIOTE_IN_MAX) return NRF_ERROR_NO_MEM;
+
+    // Кнопки замыкают вывод на землю, без нажатия - высокий уровень
+    m_inputs[m_input_count++] = (gpiote_in_t) {
+        .pin     = pin,
+        .handler = evt_handler,
+        .level   = true
+    };
+    return NRF_SUCCESS;
+}
+
+bool nrfx_gpiote_in_is_set(nrfx_gpiote_pin_t pin)
+{
+    gpiote_in_t const * p_input = input_find(pin);
+    return (p_input != NULL) ? p_input->level : true;
+}
+
+void nrfx_gpiote_in_event_enable(nrfx_gpiote_pin_t pin, bool int_enable)
+{
+    gpiote_in_t * p_input = input_find(pin);
+    if (p_input == NULL) return;
+
+    p_input->event_enabled = true;
+    p_input->int_enabled   = int_enable;
+}
+
+void nrfx_gpiote_in_event_disable(nrfx_gpiote_pin_t pin)
+{
+    gpiote_in_t * p_input = input_find(pin);
+    if (p_input == NULL) return;
+
+    p_input->event_enabled = false;
+    p_input->int_enabled   = false;
+}
+
+static void button_signal_handler(int signo)
+{
+    m_button_request = (signo == SIGUSR1) ? 1 : 0;
+}
+
+void sim_gpio_signals_init(sigset_t * p_wait_mask)
+{
+    struct sigaction action = { .sa_handler = button_signal_handler };
+    sigset_t block;
+
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, NULL);
+    sigaction(SIGUSR2, &action, NULL);
+
+    // Вне сна сигналы ждут: флаг не потеряется между проверкой и ppoll()
+    sigemptyset(&block);
+    sigaddset(&block, SIGUSR1);
+    sigaddset(&block, SIGUSR2);
+    sigprocmask(SIG_BLOCK, &block, p_wait_mask);
+    sigdelset(p_wait_mask, SIGUSR1);
+    sigdelset(p_wait_mask, SIGUSR2);
+}
+
+static void input_set(gpiote_in_t * p_input, bool level)
+{
+    if (level == p_input->level) return;
+    p_input->level = level;
+
+    if (p_input->int_enabled && (p_input->handler != NULL))
+    {
+        p_input->handler(p_input->pin, level ? NRF_GPIOTE_POLARITY_LOTOHI : NRF_GPIOTE_POLARITY_HITOLO);
+    }
+}
+
+// Сигналы управляют первым входом - кнопкой 0 приложения
+void sim_gpio_process(void)
+{
+    if ((m_button_request < 0) || (m_input_count == 0)) return;
+
+    bool level = (m_button_request == 0);
+    m_button_request = -1;
+    input_set(&m_inputs[0], level);
+}
+
+void sim_gpio_set(uint32_t pin, bool level)
+{
+    gpiote_in_t * p_input = input_find(pin);
+    if (p_input != NULL)
+    {
+        input_set(p_input, level);
+    }
+}
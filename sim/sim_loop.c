@@ -0,0 +1,81 @@
+#define _GNU_SOURCE
+#include "sim.h"
+#include "nrf_pwr_mgmt.h"
+#include "sdk_common.h"
+#include <signal.h>
+#include <time.h>
+
+// Сон без событий, мс: за это время проверяется открытие закрытого порта
+#define IDLE_MAX_MS     100
+
+static bool     m_wake = false;
+static bool     m_signals_ready = false;
+static sigset_t m_wait_mask;
+
+uint64_t sim_time_us(void)
+{
+    static uint64_t start_ns;
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    if (start_ns == 0) start_ns = now_ns;
+
+    return (now_ns - start_ns) / 1000;
+}
+
+void sim_wake(void)
+{
+    m_wake = true;
+}
+
+// Ожидание следующего события: срабатывания таймера, данных pty, сигнала кнопки.
+// Все "прерывания" выполняются здесь, в основном потоке
+void nrf_pwr_mgmt_run(void)
+{
+    if (!m_signals_ready)
+    {
+        sim_gpio_signals_init(&m_wait_mask);
+        m_signals_ready = true;
+    }
+
+    // Значения каналов, измененные основным циклом
+    sim_pwm_process();
+
+    uint64_t timeout_us = (uint64_t)IDLE_MAX_MS * 1000;
+    if (m_wake || sim_pwm_pending())
+    {
+        timeout_us = 0;
+    }
+    else
+    {
+        uint64_t now  = sim_time_us();
+        uint64_t next = sim_timer_next_us();
+        if (next != SIM_TIME_NEVER)
+        {
+            timeout_us = (next > now) ? MIN(next - now, timeout_us) : 0;
+        }
+    }
+    m_wake = false;
+
+    struct pollfd pfd;
+    sim_cdc_acm_pollfd(&pfd);
+
+    struct timespec ts = {
+        .tv_sec  = timeout_us / 1000000,
+        .tv_nsec = (timeout_us % 1000000) * 1000
+    };
+    // Сигналы кнопки разрешены только на время сна
+    if (ppoll(&pfd, 1, &ts, &m_wait_mask) < 0)
+    {
+        pfd.revents = 0;
+    }
+
+    sim_gpio_process();
+    sim_cdc_acm_process(pfd.revents);
+    sim_timer_process();
+    sim_pwm_process();
+
+    // События во время сна уже обработаны
+    m_wake = false;
+}
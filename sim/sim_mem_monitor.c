@@ -0,0 +1,46 @@
+#include "mem_monitor.h"
+#include <string.h>
+#include <malloc.h>
+#include <sys/resource.h>
+
+// Стек и куча процесса хоста: резерв стека - RLIMIT_STACK, глубина -
+// от кадра main(), пик - по вызовам mem_monitor_get(). Областей RAM
+// устройства нет
+
+static uintptr_t m_stack_top;
+static uint32_t  m_stack_peak;
+static uint32_t  m_heap_peak;
+
+void mem_monitor_init(void)
+{
+    char marker;
+    m_stack_top = (uintptr_t)&marker;
+}
+
+void mem_monitor_get(mem_usage_t * p_usage)
+{
+    char marker;
+    struct rlimit limit;
+    struct mallinfo2 info = mallinfo2();
+
+    memset(p_usage, 0, sizeof(*p_usage));
+
+    p_usage->stack_size = UINT32_MAX;
+    if ((getrlimit(RLIMIT_STACK, &limit) == 0) && (limit.rlim_cur < UINT32_MAX))
+    {
+        p_usage->stack_size = (uint32_t)limit.rlim_cur;
+    }
+    p_usage->stack_current = (uint32_t)(m_stack_top - (uintptr_t)&marker);
+    if (p_usage->stack_current > m_stack_peak) m_stack_peak = p_usage->stack_current;
+    p_usage->stack_peak = m_stack_peak;
+
+    p_usage->heap_size   = (uint32_t)info.arena;
+    p_usage->heap_in_use = (uint32_t)info.uordblks;
+    if (p_usage->heap_in_use > m_heap_peak) m_heap_peak = p_usage->heap_in_use;
+    p_usage->heap_peak = m_heap_peak;
+}
+
+uint32_t mem_monitor_sections(mem_section_t * p_sections, uint32_t max_count)
+{
+    return 0;
+}
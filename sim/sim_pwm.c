@@ -0,0 +1,203 @@
+#include "sim.h"
+#include "nrfx_pwm.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Журнал ШИМ по умолчанию
+#define PWM_LOG_DEFAULT     "sim_pwm.csv"
+
+NRF_PWM_Type nrfx_pwm_sim_regs[NRFX_PWM_INSTANCE_COUNT];
+
+typedef struct
+{
+    nrfx_pwm_handler_t          handler;
+    nrf_pwm_dec_load_t          load_mode;
+    nrf_pwm_sequence_t          seq;
+    uint32_t                    flags;
+    bool                        initialized;
+    bool                        playing;
+    bool                        stopping;   // Остановка без ожидания, STOPPED еще не выдано
+    bool                        logged;     // В журнале уже есть строка экземпляра
+    nrf_pwm_values_individual_t last;       // Последние записанные значения
+} pwm_state_t;
+
+static pwm_state_t m_pwm[NRFX_PWM_INSTANCE_COUNT];
+static FILE *      m_p_log;
+
+ret_code_t nrfx_pwm_init(nrfx_pwm_t const * p_instance, nrfx_pwm_config_t const * p_config,
+                         nrfx_pwm_handler_t handler)
+{
+    pwm_state_t * p_pwm = &m_pwm[p_instance->drv_inst_idx];
+
+    if (p_pwm->initialized) return NRF_ERROR_INVALID_STATE;
+
+    p_pwm->handler     = handler;
+    p_pwm->load_mode   = p_config->load_mode;
+    p_pwm->initialized = true;
+
+    if ((m_p_log == NULL) && (p_config->load_mode == NRF_PWM_LOAD_INDIVIDUAL))
+    {
+        const char * p_path = getenv("ESTC_SIM_PWM_LOG");
+        m_p_log = fopen((p_path != NULL) ? p_path : PWM_LOG_DEFAULT, "w");
+        if (m_p_log != NULL)
+        {
+            fprintf(m_p_log, "time_us,pwm,ch0,ch1,ch2,ch3\n");
+        }
+    }
+    return NRF_SUCCESS;
+}
+
+uint32_t nrfx_pwm_simple_playback(nrfx_pwm_t const * p_instance, nrf_pwm_sequence_t const * p_sequence,
+                                  uint16_t playback_count, uint32_t flags)
+{
+    pwm_state_t * p_pwm = &m_pwm[p_instance->drv_inst_idx];
+
+    // Как регистры SEQ[0]: указатель на значения сохраняется, описание копируется
+    p_pwm->seq     = *p_sequence;
+    p_pwm->flags   = flags;
+    p_pwm->playing = true;
+    return 0;
+}
+
+bool nrfx_pwm_stop(nrfx_pwm_t const * p_instance, bool wait_until_stopped)
+{
+    pwm_state_t * p_pwm = &m_pwm[p_instance->drv_inst_idx];
+
+    if (!p_pwm->playing) return !p_pwm->stopping;
+
+    // Без ожидания периферия останавливается в конце периода: событие STOPPED
+    // выдается в следующем проходе цикла
+    p_pwm->playing  = false;
+    p_pwm->stopping = !wait_until_stopped;
+    return wait_until_stopped;
+}
+
+bool nrfx_pwm_is_stopped(nrfx_pwm_t const * p_instance)
+{
+    pwm_state_t const * p_pwm = &m_pwm[p_instance->drv_inst_idx];
+    return !p_pwm->playing && !p_pwm->stopping;
+}
+
+bool sim_pwm_pending(void)
+{
+    for (uint32_t i = 0; i < NRFX_PWM_INSTANCE_COUNT; i++)
+    {
+        pwm_state_t const * p_pwm = &m_pwm[i];
+
+        if (p_pwm->stopping) return true;
+        if (!p_pwm->playing) continue;
+        if (p_pwm->flags & NRFX_PWM_FLAG_STOP) return true;
+        // LOOPSDONE циклического воспроизведения без NO_EVT_FINISHED
+        if ((p_pwm->flags & NRFX_PWM_FLAG_LOOP) && !(p_pwm->flags & NRFX_PWM_FLAG_NO_EVT_FINISHED))
+        {
+            return true;
+        }
+        if ((p_pwm->flags & NRFX_PWM_FLAG_SIGNAL_END_SEQ0) &&
+            (nrfx_pwm_sim_regs[i].inten & NRF_PWM_INT_SEQEND0_MASK))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void sim_pwm_output(uint32_t index, uint16_t p_values[4])
+{
+    pwm_state_t const * p_pwm = &m_pwm[index];
+    nrf_pwm_values_individual_t values = { 0 };
+
+    if (p_pwm->playing)
+    {
+        values = *p_pwm->seq.values.p_individual;
+    }
+    p_values[0] = values.channel_0;
+    p_values[1] = values.channel_1;
+    p_values[2] = values.channel_2;
+    p_values[3] = values.channel_3;
+}
+
+bool sim_pwm_sequence(uint32_t index, uint16_t const ** pp_values, uint32_t * p_length)
+{
+    pwm_state_t const * p_pwm = &m_pwm[index];
+
+    if (!p_pwm->playing) return false;
+
+    *pp_values = p_pwm->seq.values.p_raw;
+    *p_length  = p_pwm->seq.length;
+    return true;
+}
+
+// Строка журнала при изменении значений на выходе. Остановленный ШИМ - нули
+static void pwm_log(uint32_t index)
+{
+    pwm_state_t * p_pwm = &m_pwm[index];
+    nrf_pwm_values_individual_t values = { 0 };
+
+    if (p_pwm->playing)
+    {
+        values = *p_pwm->seq.values.p_individual;
+    }
+    if (p_pwm->logged && (memcmp(&values, &p_pwm->last, sizeof(values)) == 0)) return;
+
+    p_pwm->last   = values;
+    p_pwm->logged = true;
+    fprintf(m_p_log, "%llu,%u,%u,%u,%u,%u\n", (unsigned long long)sim_time_us(), (unsigned)index,
+            values.channel_0, values.channel_1, values.channel_2, values.channel_3);
+    fflush(m_p_log);
+}
+
+void sim_pwm_process(void)
+{
+    for (uint32_t i = 0; i < NRFX_PWM_INSTANCE_COUNT; i++)
+    {
+        pwm_state_t * p_pwm = &m_pwm[i];
+
+        if (!p_pwm->initialized) continue;
+
+        if ((m_p_log != NULL) && (p_pwm->load_mode == NRF_PWM_LOAD_INDIVIDUAL))
+        {
+            pwm_log(i);
+        }
+
+        if (p_pwm->stopping)
+        {
+            // Запущенное обработчиком STOPPED воспроизведение выводится в следующем проходе
+            p_pwm->stopping = false;
+            if (p_pwm->handler != NULL)
+            {
+                p_pwm->handler(NRFX_PWM_EVT_STOPPED);
+            }
+            continue;
+        }
+
+        if (!p_pwm->playing || (p_pwm->handler == NULL)) continue;
+
+        // Последовательность считается выведенной за один проход цикла
+        if (p_pwm->flags & NRFX_PWM_FLAG_STOP)
+        {
+            if (!(p_pwm->flags & NRFX_PWM_FLAG_NO_EVT_FINISHED))
+            {
+                p_pwm->handler(NRFX_PWM_EVT_FINISHED);
+            }
+            // Сокращение LOOPSDONE->STOP срабатывает и после FINISHED: запуск
+            // из его обработчика тоже останавливается, STOPPED - в следующем проходе
+            p_pwm->playing  = false;
+            p_pwm->stopping = true;
+            continue;
+        }
+
+        if ((p_pwm->flags & NRFX_PWM_FLAG_LOOP) && !(p_pwm->flags & NRFX_PWM_FLAG_NO_EVT_FINISHED))
+        {
+            // Прерывание LOOPSDONE каждого цикла, воспроизведение продолжается
+            p_pwm->handler(NRFX_PWM_EVT_FINISHED);
+        }
+
+        if (!p_pwm->playing) continue;
+
+        if ((p_pwm->flags & NRFX_PWM_FLAG_SIGNAL_END_SEQ0) &&
+            (nrfx_pwm_sim_regs[i].inten & NRF_PWM_INT_SEQEND0_MASK))
+        {
+            p_pwm->handler(NRFX_PWM_EVT_END_SEQ0);
+        }
+    }
+}
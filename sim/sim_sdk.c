@@ -0,0 +1,91 @@
+#include "sdk_common.h"
+#include "crc16.h"
+#include "nrf_fprintf.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Библиотеки SDK, которые нельзя собрать для хоста как есть
+
+// Строка форматирования за один вызов
+#define FPRINTF_LINE_MAX    256
+
+void app_error_handler(ret_code_t error_code, uint32_t line_num, const char * p_file_name)
+{
+    fprintf(stderr, "app_error 0x%08X at %s:%u\n", (unsigned)error_code, p_file_name, (unsigned)line_num);
+    abort();
+}
+
+uint16_t crc16_compute(uint8_t const * p_data, uint32_t size, uint16_t const * p_crc)
+{
+    uint16_t crc = (p_crc == NULL) ? 0xFFFF : *p_crc;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc  = (uint8_t)(crc >> 8) | (crc << 8);
+        crc ^= p_data[i];
+        crc ^= (uint8_t)(crc & 0xFF) >> 4;
+        crc ^= (crc << 8) << 4;
+        crc ^= ((crc & 0xFF) << 4) << 1;
+    }
+    return crc;
+}
+
+void nrf_fprintf_buffer_flush(nrf_fprintf_ctx_t * const p_ctx)
+{
+    if (p_ctx->io_buffer_cnt == 0) return;
+
+    p_ctx->fwrite(p_ctx->p_user_ctx, p_ctx->p_io_buffer, p_ctx->io_buffer_cnt);
+    p_ctx->io_buffer_cnt = 0;
+}
+
+static void buffer_add(nrf_fprintf_ctx_t * const p_ctx, char c)
+{
+#if NRF_FPRINTF_FLAG_AUTOMATIC_CR_ON_LF_ENABLED
+    if (c == '\n') buffer_add(p_ctx, '\r');
+#endif
+    p_ctx->p_io_buffer[p_ctx->io_buffer_cnt++] = c;
+
+    if (p_ctx->io_buffer_cnt >= p_ctx->io_buffer_size)
+    {
+        if (p_ctx->auto_flush)
+        {
+            nrf_fprintf_buffer_flush(p_ctx);
+        }
+        else
+        {
+            // Как в SDK без сброса: буфер переписывается сначала
+            p_ctx->io_buffer_cnt = 0;
+        }
+    }
+}
+
+void nrf_fprintf_fmt(nrf_fprintf_ctx_t * const p_ctx, char const * p_fmt, va_list * p_args)
+{
+    char line[FPRINTF_LINE_MAX];
+    va_list args;
+
+    va_copy(args, *p_args);
+    int length = vsnprintf(line, sizeof(line), p_fmt, args);
+    va_end(args);
+
+    if (length < 0) return;
+    if (length >= (int)sizeof(line)) length = sizeof(line) - 1;
+
+    for (int i = 0; i < length; i++)
+    {
+        buffer_add(p_ctx, line[i]);
+    }
+
+    if (p_ctx->auto_flush)
+    {
+        nrf_fprintf_buffer_flush(p_ctx);
+    }
+}
+
+void nrf_fprintf(nrf_fprintf_ctx_t * const p_ctx, char const * p_fmt, ...)
+{
+    va_list args;
+    va_start(args, p_fmt);
+    nrf_fprintf_fmt(p_ctx, p_fmt, &args);
+    va_end(args);
+}
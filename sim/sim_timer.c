@@ -0,0 +1,241 @@
+#include "sim.h"
+#include "app_timer.h"
+#include "nrfx_timer.h"
+
+// app_timer: счетчик RTC1 с делителем APP_TIMER_CONFIG_RTC_FREQUENCY + 1
+#define RTC_PRESCALER       (APP_TIMER_CONFIG_RTC_FREQUENCY + 1)
+#define TICKS_TO_US(ticks)  ((uint64_t)(ticks) * 1000000ULL * RTC_PRESCALER / APP_TIMER_CLOCK_FREQ)
+
+// Обработчиков за один вызов sim_timer_process(), защита от таймера с нулевым периодом
+#define PROCESS_MAX_CALLS   64
+
+#define TIMER_INSTANCE_COUNT    5
+
+static app_timer_t * m_p_timers;       // Созданные таймеры
+static uint64_t      m_init_us;
+
+typedef struct
+{
+    nrfx_timer_event_handler_t handler;
+    void *                     p_context;
+    nrf_timer_frequency_t      frequency;
+    bool                       enabled;
+    uint64_t                   clear_us;    // Момент, когда счетчик был равен 0
+    uint32_t                   cc;          // Только канал 0
+    uint32_t                   shorts;
+    bool                       int_enabled;
+    bool                       fired;       // Совпадение без CLEAR: до сброса больше не наступит
+} timer_state_t;
+
+static timer_state_t m_timers[TIMER_INSTANCE_COUNT];
+
+ret_code_t app_timer_init(void)
+{
+    m_init_us = sim_time_us();
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_create(app_timer_id_t const * p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    app_timer_t * p_timer = *p_timer_id;
+
+    if (timeout_handler == NULL) return NRF_ERROR_INVALID_PARAM;
+
+    p_timer->handler = timeout_handler;
+    p_timer->mode    = mode;
+    p_timer->active  = false;
+
+    for (app_timer_t * p = m_p_timers; p != NULL; p = p->p_next)
+    {
+        if (p == p_timer) return NRF_SUCCESS;
+    }
+    p_timer->p_next = m_p_timers;
+    m_p_timers = p_timer;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context)
+{
+    if (timeout_ticks < APP_TIMER_MIN_TIMEOUT_TICKS) return NRF_ERROR_INVALID_PARAM;
+    if (timer_id->handler == NULL) return NRF_ERROR_INVALID_STATE;
+
+    // Как в app_timer2: запуск работающего таймера не перезапускает его
+    if (timer_id->active) return NRF_SUCCESS;
+
+    timer_id->p_context = p_context;
+    timer_id->period_us = TICKS_TO_US(timeout_ticks);
+    timer_id->expire_us = sim_time_us() + timer_id->period_us;
+    timer_id->active    = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    timer_id->active = false;
+    return NRF_SUCCESS;
+}
+
+uint32_t app_timer_cnt_get(void)
+{
+    uint64_t elapsed_us = sim_time_us() - m_init_us;
+    return (uint32_t)(elapsed_us * APP_TIMER_CLOCK_FREQ / (1000000ULL * RTC_PRESCALER)) & APP_TIMER_MAX_CNT_VAL;
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from)
+{
+    return (ticks_to - ticks_from) & APP_TIMER_MAX_CNT_VAL;
+}
+
+// Период тика TIMERn: 16 МГц >> frequency
+static uint64_t timer_ticks_to_us(timer_state_t const * p_timer, uint32_t ticks)
+{
+    return ((uint64_t)ticks << p_timer->frequency) / 16;
+}
+
+ret_code_t nrfx_timer_init(nrfx_timer_t const * p_instance, nrfx_timer_config_t const * p_config,
+                           nrfx_timer_event_handler_t timer_event_handler)
+{
+    timer_state_t * p_timer = &m_timers[p_instance->instance_id];
+
+    if (p_timer->handler != NULL) return NRF_ERROR_INVALID_STATE;
+
+    p_timer->handler   = timer_event_handler;
+    p_timer->p_context = p_config->p_context;
+    p_timer->frequency = p_config->frequency;
+    return NRF_SUCCESS;
+}
+
+void nrfx_timer_enable(nrfx_timer_t const * p_instance)
+{
+    timer_state_t * p_timer = &m_timers[p_instance->instance_id];
+
+    if (!p_timer->enabled)
+    {
+        p_timer->enabled  = true;
+        p_timer->clear_us = sim_time_us();
+    }
+}
+
+void nrfx_timer_disable(nrfx_timer_t const * p_instance)
+{
+    m_timers[p_instance->instance_id].enabled = false;
+}
+
+void nrfx_timer_clear(nrfx_timer_t const * p_instance)
+{
+    timer_state_t * p_timer = &m_timers[p_instance->instance_id];
+
+    p_timer->clear_us = sim_time_us();
+    p_timer->fired    = false;
+}
+
+void nrfx_timer_extended_compare(nrfx_timer_t const * p_instance, nrf_timer_cc_channel_t cc_channel,
+                                 uint32_t cc_value, uint32_t timer_short_mask, bool enable_int)
+{
+    timer_state_t * p_timer = &m_timers[p_instance->instance_id];
+
+    // Модули приложения используют только канал 0
+    if (cc_channel != NRF_TIMER_CC_CHANNEL0) return;
+
+    p_timer->cc          = cc_value;
+    p_timer->shorts      = timer_short_mask;
+    p_timer->int_enabled = enable_int;
+    p_timer->fired       = false;
+}
+
+uint32_t nrfx_timer_us_to_ticks(nrfx_timer_t const * p_instance, uint32_t time_us)
+{
+    return (uint32_t)(((uint64_t)time_us * 16) >> m_timers[p_instance->instance_id].frequency);
+}
+
+static uint64_t timer_compare_us(timer_state_t const * p_timer)
+{
+    if (!p_timer->enabled || !p_timer->int_enabled || p_timer->fired || p_timer->cc == 0)
+    {
+        return SIM_TIME_NEVER;
+    }
+    return p_timer->clear_us + timer_ticks_to_us(p_timer, p_timer->cc);
+}
+
+uint64_t sim_timer_next_us(void)
+{
+    uint64_t next = SIM_TIME_NEVER;
+
+    for (app_timer_t * p = m_p_timers; p != NULL; p = p->p_next)
+    {
+        if (p->active && (p->expire_us < next)) next = p->expire_us;
+    }
+    for (uint32_t i = 0; i < TIMER_INSTANCE_COUNT; i++)
+    {
+        uint64_t compare_us = timer_compare_us(&m_timers[i]);
+        if (compare_us < next) next = compare_us;
+    }
+    return next;
+}
+
+static void timer_compare(timer_state_t * p_timer, uint64_t now)
+{
+    uint64_t period_us = timer_ticks_to_us(p_timer, p_timer->cc);
+
+    if (p_timer->shorts & NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK)
+    {
+        // Пропущенные периоды, как у задержанного прерывания, дают одно событие
+        p_timer->clear_us += ((now - p_timer->clear_us) / period_us) * period_us;
+    }
+    else
+    {
+        if (p_timer->shorts & NRF_TIMER_SHORT_COMPARE0_STOP_MASK) p_timer->enabled = false;
+        p_timer->fired = true;
+    }
+
+    if (p_timer->handler != NULL)
+    {
+        p_timer->handler(NRF_TIMER_EVENT_COMPARE0, p_timer->p_context);
+    }
+}
+
+void sim_timer_process(void)
+{
+    for (uint32_t calls = 0; calls < PROCESS_MAX_CALLS; calls++)
+    {
+        uint64_t now = sim_time_us();
+
+        // Самый ранний из истекших app_timer
+        app_timer_t * p_expired = NULL;
+        for (app_timer_t * p = m_p_timers; p != NULL; p = p->p_next)
+        {
+            if (p->active && (p->expire_us <= now) &&
+                ((p_expired == NULL) || (p->expire_us < p_expired->expire_us)))
+            {
+                p_expired = p;
+            }
+        }
+
+        if (p_expired != NULL)
+        {
+            if (p_expired->mode == APP_TIMER_MODE_REPEATED)
+            {
+                p_expired->expire_us += p_expired->period_us;
+                if (p_expired->expire_us <= now) p_expired->expire_us = now + p_expired->period_us;
+            }
+            else
+            {
+                p_expired->active = false;
+            }
+            p_expired->handler(p_expired->p_context);
+            continue;
+        }
+
+        bool compared = false;
+        for (uint32_t i = 0; i < TIMER_INSTANCE_COUNT; i++)
+        {
+            if (timer_compare_us(&m_timers[i]) <= now)
+            {
+                timer_compare(&m_timers[i], now);
+                compared = true;
+            }
+        }
+        if (!compared) return;
+    }
+}
@@ -0,0 +1,232 @@
+#include "test.h"
+#include "bin_proto.h"
+#include "cli_parse.h"
+#include "app_logic.h"
+#include "color_stream.h"
+#include "crc16.h"
+#include "event_queue.h"
+#include "pwm_handler.h"
+#include "sdk_common.h"
+#include "ws2812_handler.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Замеры горячих путей на хосте (make -C sim bench): время операции в нс.
+// Абсолютные значения - хоста, не nRF52840; сравнивать между собой
+// сборки и версии кода на одной машине
+
+// Время замера одного пути
+#define BENCH_TIME_NS       200000000ULL
+// Операций между проверками времени
+#define BENCH_BATCH         1024
+
+static volatile uint32_t m_sink;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_run(const char * p_name, void (*op)(uint32_t i))
+{
+    uint64_t start = now_ns();
+    uint64_t elapsed;
+    uint32_t count = 0;
+
+    do
+    {
+        for (uint32_t i = 0; i < BENCH_BATCH; i++)
+        {
+            op(count + i);
+        }
+        count += BENCH_BATCH;
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_TIME_NS);
+
+    printf("%-20s %10.1f ns/op\n", p_name, (double)elapsed / count);
+}
+
+static void op_crc16(uint32_t i)
+{
+    uint8_t data[8] = { (uint8_t)i, 1, 2, 3, 4, 5, 6, 7 };
+    m_sink += crc16_compute(data, sizeof(data), NULL);
+}
+
+// SET_HSV: h 200, s 50, v 60
+static uint8_t  m_hsv_frame[TEST_FRAME_MAX];
+static size_t   m_hsv_frame_len;
+
+static bool null_write(uint8_t const * p_data, size_t length)
+{
+    m_sink += length;
+    return true;
+}
+
+static void op_bin_frame(uint32_t i)
+{
+    // Один и тот же seq: растет только счетчик пропусков
+    for (uint32_t j = 0; j < m_hsv_frame_len; j++)
+    {
+        bin_proto_rx_byte(m_hsv_frame[j]);
+    }
+}
+
+static const char * const m_numbers[] = { "255", "0xFF", "4294967295", "12a" };
+
+static void op_parse_uint(uint32_t i)
+{
+    uint32_t value = 0;
+    cli_parse_uint(m_numbers[i & 3], 0, UINT32_MAX, &value);
+    m_sink += value;
+}
+
+// Разбор до cli_parse: atoi без проверок
+static void op_atoi(uint32_t i)
+{
+    m_sink += (uint32_t)atoi(m_numbers[i & 3]);
+}
+
+static void op_parse_color(uint32_t i)
+{
+    uint8_t r, g, b;
+    cli_parse_color("#12abEF", &r, &g, &b);
+    m_sink += r;
+}
+
+// Каждый раз другой оттенок: пересчет HSV -> RGB и запись в ШИМ
+static void op_render_miss(uint32_t i)
+{
+    app_logic_show_hsv(i % 360, 100, 100);
+}
+
+static void op_render_hit(uint32_t i)
+{
+    app_logic_show_hsv(120, 100, 100);
+}
+
+// Каждый раз другой оттенок: пересчет HSV -> RGB, запись в ШИМ и во Flash
+static void op_set_hsv(uint32_t i)
+{
+    app_logic_set_hsv(i % 360, 100, 100);
+}
+
+// Тот же цвет: кэш вывода, сохранение пропускается после сравнения
+static void op_set_hsv_same(uint32_t i)
+{
+    app_logic_set_hsv(120, 100, 100);
+}
+
+// RGB -> HSV и вывод
+static void op_set_rgb(uint32_t i)
+{
+    app_logic_set_rgb(i % 1000, 500, 250);
+}
+
+static void op_apply_color(uint32_t i)
+{
+    app_logic_apply_color((i & 1) ? "red" : "green");
+}
+
+static void op_pwm_set_rgb(uint32_t i)
+{
+    pwm_handler_set_rgb(i % 1000, 500, 250);
+}
+
+static void op_event_queue(uint32_t i)
+{
+    app_event_t event = { .type = APP_EVENT_UPDATE_TICK, .timestamp_us = i };
+
+    event_queue_put(&event);
+    event_queue_get(&event);
+    m_sink += event.timestamp_us;
+}
+
+// 16 кадров R G B 0xFF за вызов
+static void op_stream_rx(uint32_t i)
+{
+    static uint8_t data[64];
+    size_t used;
+
+    for (uint32_t j = 0; j < sizeof(data); j += 4)
+    {
+        data[j]     = (uint8_t)((i + j) % 0xFF);
+        data[j + 1] = 10;
+        data[j + 2] = 20;
+        data[j + 3] = 0xFF;
+    }
+    color_stream_rx(data, sizeof(data), &used);
+}
+
+// Заливка и кодирование кадра; пока лента занята, кадр перезаписывает ожидающий
+static void op_strip_show(uint32_t i)
+{
+    ws2812_handler_fill((uint8_t)i, 0x55, 0xAA);
+    ws2812_handler_show();
+}
+
+// Кодирование кадра против времени его передачи для нескольких длин ленты
+static void bench_strip(void)
+{
+    static const uint16_t lengths[] = { 8, 32, WS2812_MAX_PIXELS };
+    char name[24];
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(lengths); i++)
+    {
+        while (ws2812_handler_is_busy())
+        {
+            sim_pwm_process();
+        }
+        ws2812_handler_set_length(lengths[i]);
+
+        snprintf(name, sizeof(name), "strip show %u px", (unsigned)lengths[i]);
+        bench_run(name, op_strip_show);
+
+        uint32_t frame_us = ws2812_handler_frame_time_us();
+        printf("%-20s %10u us, %u fps max\n", "  wire frame", (unsigned)frame_us,
+               (unsigned)(1000000 / frame_us));
+    }
+    while (ws2812_handler_is_busy())
+    {
+        sim_pwm_process();
+    }
+    ws2812_handler_set_length(TEST_WS2812_PIXELS);
+}
+
+int main(void)
+{
+    test_platform_init();
+    bin_proto_init(null_write);
+    m_hsv_frame_len = test_frame_build(0, BIN_CMD_SET_HSV, (uint8_t const []) { 200, 0, 50, 60 }, 4, 0,
+                                       m_hsv_frame);
+
+    bench_run("crc16 8 B", op_crc16);
+    bench_run("bin SET_HSV frame", op_bin_frame);
+    bench_run("atoi (old)", op_atoi);
+    bench_run("cli_parse_uint", op_parse_uint);
+    bench_run("cli_parse_color", op_parse_color);
+    bench_run("render miss", op_render_miss);
+    bench_run("render hit", op_render_hit);
+    bench_run("set_hsv new", op_set_hsv);
+    bench_run("set_hsv same", op_set_hsv_same);
+    bench_run("set_rgb", op_set_rgb);
+    bench_run("pwm_set_rgb", op_pwm_set_rgb);
+    bench_run("event_queue", op_event_queue);
+
+    app_logic_save_color_hsv(0, 100, 100, "red");
+    app_logic_save_color_hsv(120, 100, 100, "green");
+    bench_run("apply_color", op_apply_color);
+    app_logic_del_color("red");
+    app_logic_del_color("green");
+    bench_strip();
+
+    // Очередь полна почти сразу: замеряется разбор, не вывод
+    color_stream_start(100, 4);
+    bench_run("stream_rx 16 frames", op_stream_rx);
+    uint16_t r, g, b;
+    color_stream_stop(&r, &g, &b);
+    return 0;
+}
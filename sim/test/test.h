@@ -0,0 +1,51 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Тесты модулей приложения на симуляторе (make -C sim test).
+//
+// Программа собирается из тех же объектов, что и esl_sim, кроме main.c:
+// периферия - модели sim/, время - монотонные часы хоста. Непрошедшая
+// проверка печатает место и выражение, выполнение продолжается; код
+// возврата - число непрошедших проверок.
+
+#define CHECK(expr)         test_check((expr), #expr, __FILE__, __LINE__)
+#define CHECK_EQ(a, b)      test_check_eq((long long)(a), (long long)(b), #a " == " #b, __FILE__, __LINE__)
+
+bool test_check(bool ok, const char * p_expr, const char * p_file, int line);
+bool test_check_eq(long long actual, long long expected, const char * p_expr, const char * p_file, int line);
+
+// Вывод кнопки 0 (как в main.c)
+#define TEST_BUTTON_PIN     38
+// Экземпляр ШИМ светодиодов: канал 0 - индикатор, 1-3 - R, G, B
+#define TEST_PWM_LEDS       0
+// Экземпляр ШИМ ленты WS2812 и ее длина (как в main.c)
+#define TEST_PWM_WS2812     1
+#define TEST_WS2812_PIN     29
+#define TEST_WS2812_PIXELS  8
+
+// Инициализация модулей в порядке main.c
+void test_platform_init(void);
+
+// Выполнение "прерываний" симулятора не меньше ms миллисекунд
+void test_run_ms(uint32_t ms);
+
+// Кадр двоичного протокола хоста: 0x00, COBS(seq, cmd, данные, CRC), 0x00.
+// crc_xor портит CRC. Возвращает длину кадра
+#define TEST_FRAME_MAX      64
+size_t test_frame_build(uint8_t seq, uint8_t cmd, uint8_t const * p_data, size_t length,
+                        uint16_t crc_xor, uint8_t * p_frame);
+
+// Группы тестов
+void test_bin_proto(void);
+void test_cli_parse(void);
+void test_render(void);
+void test_app_logic(void);
+void test_button(void);
+void test_ws2812(void);
+void test_usb_cli(void);
+
+#endif
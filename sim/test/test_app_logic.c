@@ -0,0 +1,272 @@
+#include "test.h"
+#include "sim.h"
+#include "app_logic.h"
+#include "event_queue.h"
+#include "button_handler.h"
+#include <string.h>
+#include <unistd.h>
+
+// Запись списка по имени (NULL - нет)
+static saved_color_entry_t const * entry_find(const char * p_name)
+{
+    uint8_t count;
+    saved_color_entry_t const * p_list = app_logic_get_list(&count);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (strcmp(p_list[i].name, p_name) == 0) return &p_list[i];
+    }
+    return NULL;
+}
+
+// Текущий цвет через сохранение во временную запись списка
+static app_logic_hsv_t current_color(void)
+{
+    app_logic_hsv_t color = { 0 };
+
+    if (app_logic_save_current_color("~cur"))
+    {
+        color = entry_find("~cur")->color;
+        app_logic_del_color("~cur");
+    }
+    return color;
+}
+
+static void button_post(button_event_t event)
+{
+    app_event_t app_event = { .type = APP_EVENT_BUTTON, .arg = event, .id = 0 };
+    event_queue_put(&app_event);
+    app_logic_process();
+}
+
+// Основной цикл: события очереди и "прерывания"
+static void app_run_ms(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        app_logic_process();
+        test_run_ms(1);
+    }
+    app_logic_process();
+}
+
+static uint16_t indicator(void)
+{
+    uint16_t out[4];
+
+    test_run_ms(1);
+    sim_pwm_output(TEST_PWM_LEDS, out);
+    return out[0];
+}
+
+static void conversion_test(void)
+{
+    app_logic_hsv_t color;
+
+    // RGB 0-1000 -> HSV
+    app_logic_set_rgb(1000, 0, 0);
+    color = current_color();
+    CHECK_EQ(color.h, 0);
+    CHECK_EQ(color.s, 100);
+    CHECK_EQ(color.v, 100);
+
+    app_logic_set_rgb(0, 500, 500);
+    color = current_color();
+    CHECK_EQ(color.h, 180);
+    CHECK_EQ(color.s, 100);
+    CHECK_EQ(color.v, 50);
+
+    app_logic_set_rgb(250, 250, 250);
+    color = current_color();
+    CHECK_EQ(color.s, 0);
+    CHECK_EQ(color.v, 25);
+
+    // Значения больше 1000 ограничиваются
+    app_logic_set_rgb(5000, 0, 0);
+    color = current_color();
+    CHECK_EQ(color.v, 100);
+
+    // HSV сохраняется как есть
+    app_logic_set_hsv(200, 40, 60);
+    color = current_color();
+    CHECK_EQ(color.h, 200);
+    CHECK_EQ(color.s, 40);
+    CHECK_EQ(color.v, 60);
+}
+
+static void palette_test(void)
+{
+    uint8_t count;
+    uint16_t out[4];
+    app_logic_flash_stats_t before, after;
+
+    app_logic_get_list(&count);
+    CHECK_EQ(count, 0);
+
+    app_logic_get_flash_stats(&before);
+    CHECK(app_logic_save_color_hsv(120, 100, 50, "green"));
+    CHECK(app_logic_save_color_rgb(0, 0, 1000, "blue"));
+    app_logic_get_flash_stats(&after);
+    CHECK_EQ(after.page_erases - before.page_erases, 2);
+
+    // Имя занято
+    CHECK(!app_logic_save_color_hsv(0, 0, 0, "green"));
+    app_logic_get_list(&count);
+    CHECK_EQ(count, 2);
+    CHECK_EQ(entry_find("blue")->color.h, 240);
+
+    CHECK(app_logic_apply_color("green"));
+    test_run_ms(1);
+    sim_pwm_output(TEST_PWM_LEDS, out);
+    CHECK_EQ(out[1], 0);
+    CHECK_EQ(out[2], 500);
+    CHECK_EQ(out[3], 0);
+    CHECK(!app_logic_apply_color("red"));
+
+    // Удаление сдвигает список
+    CHECK(app_logic_del_color("green"));
+    CHECK(!app_logic_del_color("green"));
+    CHECK(entry_find("green") == NULL);
+    CHECK(entry_find("blue") != NULL);
+    CHECK(!app_logic_apply_color("green"));
+
+    // Длинное имя обрезается
+    CHECK(app_logic_save_color_hsv(1, 2, 3, "a_very_long_color_name"));
+    CHECK(entry_find("a_very_long") != NULL);
+
+    // Список ограничен
+    char name[COLOR_NAME_LEN];
+    app_logic_get_list(&count);
+    for (uint32_t i = count; i < MAX_SAVED_COLORS; i++)
+    {
+        name[0] = 'c';
+        name[1] = '0' + i;
+        name[2] = '\0';
+        CHECK(app_logic_save_color_hsv(i, 0, 0, name));
+    }
+    CHECK(!app_logic_save_color_hsv(0, 0, 0, "extra"));
+
+    // Очистка списка
+    app_logic_get_list(&count);
+    CHECK_EQ(count, MAX_SAVED_COLORS);
+    while (count > 0)
+    {
+        CHECK(app_logic_del_color(app_logic_get_list(&count)[0].name));
+        app_logic_get_list(&count);
+    }
+}
+
+static void mode_test(void)
+{
+    app_logic_flash_stats_t before, after;
+
+    app_logic_set_hsv(100, 50, 50);
+    CHECK_EQ(indicator(), 0);
+
+    // Двойной клик: Hue (медленное мигание) -> Saturation -> Value (горит) -> выход
+    button_post(BUTTON_EVENT_DOUBLE_CLICK);
+    CHECK_EQ(indicator(), 0);
+    app_run_ms(550);
+    CHECK_EQ(indicator(), 1000);
+
+    button_post(BUTTON_EVENT_DOUBLE_CLICK);
+    button_post(BUTTON_EVENT_DOUBLE_CLICK);
+    CHECK_EQ(indicator(), 1000);
+
+    // Выход из режима сохраняет цвет; без изменений запись пропускается
+    app_logic_get_flash_stats(&before);
+    button_post(BUTTON_EVENT_DOUBLE_CLICK);
+    CHECK_EQ(indicator(), 0);
+    app_logic_get_flash_stats(&after);
+    CHECK_EQ(after.commits_skipped - before.commits_skipped, 1);
+
+    // Клик вне режима и события других кнопок ничего не меняют
+    button_post(BUTTON_EVENT_CLICK);
+    app_event_t other = { .type = APP_EVENT_BUTTON, .arg = BUTTON_EVENT_DOUBLE_CLICK, .id = 1 };
+    event_queue_put(&other);
+    app_logic_process();
+    CHECK_EQ(indicator(), 0);
+
+    // Удержание в режиме Hue: 40-55 шаг/с в первые 300 мс
+    button_post(BUTTON_EVENT_DOUBLE_CLICK);
+    button_post(BUTTON_EVENT_LONG_PRESS);
+    app_run_ms(300);
+    button_post(BUTTON_EVENT_RELEASED);
+    app_run_ms(50);
+
+    app_logic_hsv_t color = current_color();
+    CHECK(color.h >= 110 && color.h <= 118);
+    CHECK_EQ(color.s, 50);
+    CHECK_EQ(color.v, 50);
+
+    // Повтор удержания догоняет цвет и без тиков таймера обновления
+    button_post(BUTTON_EVENT_LONG_PRESS);
+    usleep(200 * 1000);
+    app_event_t repeat = { .type = APP_EVENT_BUTTON, .arg = BUTTON_EVENT_HOLD_REPEAT, .id = 0,
+                           .timestamp_us = button_handler_time_us() };
+    event_queue_put(&repeat);
+    app_logic_process();
+    button_post(BUTTON_EVENT_RELEASED);
+    app_logic_hsv_t repeated = current_color();
+    CHECK(repeated.h >= color.h + 5 && repeated.h < color.h + 60);
+    color = repeated;
+
+    // Удержание без режима цвет не меняет
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        button_post(BUTTON_EVENT_DOUBLE_CLICK);
+    }
+    button_post(BUTTON_EVENT_LONG_PRESS);
+    app_run_ms(100);
+    button_post(BUTTON_EVENT_RELEASED);
+    CHECK_EQ(current_color().h, color.h);
+}
+
+// Цвет из прерывания (отчет HID) выводится в основном цикле, без записи во Flash
+static void post_test(void)
+{
+    app_logic_flash_stats_t before, after;
+    uint16_t out[4];
+
+    app_logic_set_rgb(0, 0, 0);
+    app_logic_get_flash_stats(&before);
+
+    app_logic_post_rgb(1000, 0, 0);
+    app_logic_post_rgb(0, 0, 1000);
+    test_run_ms(1);
+    sim_pwm_output(TEST_PWM_LEDS, out);
+    CHECK_EQ(out[3], 0);
+
+    // Два вызова до обработки - одно событие с последним цветом
+    app_event_t event;
+    CHECK(event_queue_get(&event));
+    CHECK_EQ(event.type, APP_EVENT_HOST_COLOR);
+    CHECK(!event_queue_get(&event));
+    CHECK(event_queue_put(&event));
+
+    // ШИМ запускается после остановки в следующем проходе цикла
+    app_logic_process();
+    test_run_ms(1);
+    sim_pwm_output(TEST_PWM_LEDS, out);
+    CHECK_EQ(out[1], 0);
+    CHECK_EQ(out[3], 1000);
+
+    // После обработки следующий вызов снова ставит событие
+    app_logic_post_rgb(0, 1000, 0);
+    app_logic_process();
+    sim_pwm_output(TEST_PWM_LEDS, out);
+    CHECK_EQ(out[2], 1000);
+
+    app_logic_get_flash_stats(&after);
+    CHECK_EQ(after.page_erases, before.page_erases);
+    CHECK_EQ(after.words_written, before.words_written);
+    CHECK_EQ(current_color().h, 120);
+}
+
+void test_app_logic(void)
+{
+    conversion_test();
+    palette_test();
+    mode_test();
+    post_test();
+}
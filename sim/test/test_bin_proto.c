@@ -0,0 +1,161 @@
+#include "test.h"
+#include "bin_proto.h"
+#include "app_logic.h"
+#include "crc16.h"
+#include <string.h>
+
+#define MAX_FRAME   TEST_FRAME_MAX
+
+// Последний ответ устройства в обрамлении
+static uint8_t  m_reply[MAX_FRAME];
+static size_t   m_reply_len;
+static uint32_t m_replies;
+static bool     m_write_ok = true;
+
+static bool reply_write(uint8_t const * p_data, size_t length)
+{
+    if (!m_write_ok) return false;
+
+    memcpy(m_reply, p_data, length);
+    m_reply_len = length;
+    m_replies++;
+    return true;
+}
+
+// COBS хоста - отдельная от bin_proto.c реализация
+static size_t cobs_decode(uint8_t const * p_src, size_t length, uint8_t * p_dst)
+{
+    size_t out = 0;
+
+    for (size_t i = 0; i < length;)
+    {
+        uint8_t code = p_src[i++];
+        for (uint8_t j = 1; j < code; j++)
+        {
+            p_dst[out++] = p_src[i++];
+        }
+        if ((code != 0xFF) && (i < length))
+        {
+            p_dst[out++] = 0;
+        }
+    }
+    return out;
+}
+
+// Передача кадра; каждый байт должен остаться в двоичном протоколе
+static void frame_send(uint8_t seq, uint8_t cmd, uint8_t const * p_data, size_t length, uint16_t crc_xor)
+{
+    uint8_t frame[MAX_FRAME];
+    size_t  frame_len = test_frame_build(seq, cmd, p_data, length, crc_xor, frame);
+    bool    binary = true;
+
+    for (size_t i = 0; i < frame_len; i++)
+    {
+        binary &= bin_proto_rx_byte(frame[i]);
+    }
+    CHECK(binary);
+}
+
+// Разбор последнего ответа: статус или -1, данные в p_data
+static int reply_parse(uint8_t seq, uint8_t cmd, uint8_t * p_data, size_t * p_length)
+{
+    uint8_t raw[MAX_FRAME];
+
+    if ((m_reply_len < 2) || (m_reply[0] != 0) || (m_reply[m_reply_len - 1] != 0)) return -1;
+
+    size_t length = cobs_decode(&m_reply[1], m_reply_len - 2, raw);
+    if (length < 5) return -1;
+
+    length -= 2;
+    uint16_t crc = raw[length] | (raw[length + 1] << 8);
+    if (!CHECK_EQ(crc16_compute(raw, length, NULL), crc)) return -1;
+    CHECK_EQ(raw[0], seq);
+    CHECK_EQ(raw[1], cmd | 0x80);
+
+    if (p_data != NULL)
+    {
+        memcpy(p_data, &raw[3], length - 3);
+        *p_length = length - 3;
+    }
+    return raw[2];
+}
+
+void test_bin_proto(void)
+{
+    bin_proto_stats_t before, after;
+    uint8_t data[BIN_PROTO_MAX_REPLY];
+    size_t  length;
+
+    bin_proto_init(reply_write);
+    bin_proto_get_stats(&before);
+
+    // CRC-16/CCITT-FALSE, контрольное значение "123456789"
+    CHECK_EQ(crc16_compute((uint8_t const *)"123456789", 9, NULL), 0x29B1);
+
+    // Текст проходит в CLI
+    CHECK(!bin_proto_rx_byte('R'));
+    CHECK(!bin_proto_rx_byte('\r'));
+
+    // Нули в данных: COBS без 0x00 внутри кадра
+    m_replies = 0;
+    frame_send(1, BIN_CMD_SET_RGB, (uint8_t const []) { 0, 0, 255 }, 3, 0);
+    CHECK_EQ(m_replies, 1);
+    CHECK_EQ(reply_parse(1, BIN_CMD_SET_RGB, NULL, NULL), BIN_STATUS_OK);
+
+    frame_send(2, BIN_CMD_SET_HSV, (uint8_t const []) { 200, 0, 50, 60 }, 4, 0);
+    CHECK_EQ(reply_parse(2, BIN_CMD_SET_HSV, NULL, NULL), BIN_STATUS_OK);
+
+    frame_send(3, BIN_CMD_QUERY, NULL, 0, 0);
+    CHECK_EQ(reply_parse(3, BIN_CMD_QUERY, data, &length), BIN_STATUS_OK);
+    CHECK_EQ(length, 5);
+    CHECK_EQ(data[0] | (data[1] << 8), 200);
+    CHECK_EQ(data[2], 50);
+    CHECK_EQ(data[3], 60);
+
+    // Значения сверх 360/100/100 не выводятся
+    frame_send(4, BIN_CMD_SET_HSV, (uint8_t const []) { 0x69, 0x01, 50, 60 }, 4, 0);
+    CHECK_EQ(reply_parse(4, BIN_CMD_SET_HSV, NULL, NULL), BIN_STATUS_BAD_ARG);
+    frame_send(5, BIN_CMD_SET_HSV, (uint8_t const []) { 0, 0, 101, 60 }, 4, 0);
+    CHECK_EQ(reply_parse(5, BIN_CMD_SET_HSV, NULL, NULL), BIN_STATUS_BAD_ARG);
+
+    app_logic_hsv_t color;
+    app_logic_get_current(&color);
+    CHECK_EQ(color.h, 200);
+
+    frame_send(6, BIN_CMD_SET_RGB, (uint8_t const []) { 1, 2 }, 2, 0);
+    CHECK_EQ(reply_parse(6, BIN_CMD_SET_RGB, NULL, NULL), BIN_STATUS_BAD_LENGTH);
+    frame_send(7, 0x7E, NULL, 0, 0);
+    CHECK_EQ(reply_parse(7, 0x7E, NULL, NULL), BIN_STATUS_UNKNOWN_CMD);
+    frame_send(8, BIN_CMD_APPLY, (uint8_t const *)"nope", 4, 0);
+    CHECK_EQ(reply_parse(8, BIN_CMD_APPLY, NULL, NULL), BIN_STATUS_NOT_FOUND);
+
+    // Неверная CRC - без ответа
+    m_replies = 0;
+    frame_send(9, BIN_CMD_QUERY, NULL, 0, 0x0100);
+    CHECK_EQ(m_replies, 0);
+
+    // Пропуск seq 10
+    frame_send(11, BIN_CMD_QUERY, NULL, 0, 0);
+    CHECK_EQ(m_replies, 1);
+
+    // Слишком длинный кадр отбрасывается до разделителя, затем снова текст
+    CHECK(bin_proto_rx_byte(0));
+    for (uint32_t i = 0; i < BIN_PROTO_MAX_ENCODED + 8; i++)
+    {
+        CHECK(bin_proto_rx_byte(0x55));
+    }
+    CHECK(bin_proto_rx_byte(0));
+    CHECK(!bin_proto_rx_byte('R'));
+
+    // Передатчик не принял ответ
+    m_write_ok = false;
+    frame_send(12, BIN_CMD_QUERY, NULL, 0, 0);
+    m_write_ok = true;
+
+    bin_proto_get_stats(&after);
+    CHECK_EQ(after.frames - before.frames, 10);
+    CHECK_EQ(after.crc_errors - before.crc_errors, 1);
+    CHECK_EQ(after.overruns - before.overruns, 1);
+    CHECK_EQ(after.seq_gaps - before.seq_gaps, 1);
+    CHECK_EQ(after.tx_dropped - before.tx_dropped, 1);
+}
@@ -0,0 +1,121 @@
+#include "test.h"
+#include "sim.h"
+#include "button_handler.h"
+#include "event_queue.h"
+
+// Короткие тайминги, чтобы тест шел меньше секунды на сценарий
+static const button_timing_t m_timing = {
+    .debounce_ms   = 5,
+    .click_gap_ms  = 100,
+    .long_press_ms = 200,
+    .repeat_ms     = 50
+};
+
+#define EVENTS_MAX  16
+
+static uint8_t  m_events[EVENTS_MAX];
+static uint32_t m_event_count;
+
+// Кнопка активна по низкому уровню
+static void press(uint32_t ms)
+{
+    sim_gpio_set(TEST_BUTTON_PIN, false);
+    test_run_ms(ms);
+}
+
+static void release(uint32_t ms)
+{
+    sim_gpio_set(TEST_BUTTON_PIN, true);
+    test_run_ms(ms);
+}
+
+// События кнопки из очереди; тики app_logic пропускаются
+static void events_collect(void)
+{
+    app_event_t event;
+
+    m_event_count = 0;
+    while (event_queue_get(&event))
+    {
+        if ((event.type == APP_EVENT_BUTTON) && (m_event_count < EVENTS_MAX))
+        {
+            m_events[m_event_count++] = event.arg;
+        }
+    }
+}
+
+static void events_check(uint8_t const * p_expected, uint32_t count, int line)
+{
+    events_collect();
+    test_check_eq(m_event_count, count, "event count", __FILE__, line);
+    for (uint32_t i = 0; (i < count) && (i < m_event_count); i++)
+    {
+        test_check_eq(m_events[i], p_expected[i], button_handler_event_name(p_expected[i]), __FILE__, line);
+    }
+}
+
+#define EVENTS_CHECK(...)   events_check((uint8_t const []) { __VA_ARGS__ }, \
+                                         sizeof((uint8_t const []) { __VA_ARGS__ }), __LINE__)
+
+void test_button(void)
+{
+    button_timing_t saved;
+    button_latency_t latency;
+
+    button_handler_get_timing(&saved);
+    CHECK(button_handler_set_timing(&m_timing));
+    CHECK(!button_handler_set_timing(&(button_timing_t) { 0, 100, 200, 50 }));
+
+    release(50);
+    events_collect();
+    button_handler_get_latency(&latency, true);
+
+    // Клик выдается после паузы серии
+    press(30);
+    release(50);
+    events_collect();
+    CHECK_EQ(m_event_count, 0);
+    test_run_ms(100);
+    EVENTS_CHECK(BUTTON_EVENT_CLICK);
+
+    press(30);
+    release(40);
+    press(30);
+    release(150);
+    EVENTS_CHECK(BUTTON_EVENT_DOUBLE_CLICK);
+
+    // Третий клик - наибольшая серия, выдается без паузы
+    press(30);
+    release(40);
+    press(30);
+    release(40);
+    press(30);
+    release(20);
+    EVENTS_CHECK(BUTTON_EVENT_TRIPLE_CLICK);
+    test_run_ms(150);
+
+    // Удержание: начало, повторы с периодом repeat_ms, отпускание
+    press(330);
+    release(50);
+    EVENTS_CHECK(BUTTON_EVENT_LONG_PRESS, BUTTON_EVENT_HOLD_REPEAT, BUTTON_EVENT_HOLD_REPEAT,
+                 BUTTON_EVENT_RELEASED);
+
+    // Дребезг короче окна антидребезга - не нажатие. Фронты без пауз: пауза
+    // в 1 мс на загруженном хосте могла растянуться дольше окна
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        press(0);
+        release(0);
+    }
+    test_run_ms(200);
+    events_collect();
+    CHECK_EQ(m_event_count, 0);
+
+    // Задержка классификации в пределах расчетной границы
+    button_handler_get_latency(&latency, true);
+    CHECK_EQ(latency.count[BUTTON_EVENT_CLICK], 1);
+    CHECK(latency.max_us[BUTTON_EVENT_CLICK] <= button_handler_latency_bound_us(BUTTON_EVENT_CLICK));
+    CHECK(latency.max_us[BUTTON_EVENT_LONG_PRESS] <= button_handler_latency_bound_us(BUTTON_EVENT_LONG_PRESS));
+
+    button_handler_set_timing(&saved);
+}
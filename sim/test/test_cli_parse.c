@@ -0,0 +1,223 @@
+#include "test.h"
+#include "cli_parse.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Случайных строк в сравнении с эталоном
+#define FUZZ_COUNT      200000
+// Длина строки не больше 14: любое значение помещается в 64 бита
+#define FUZZ_LEN_MAX    14
+
+static void uint_check(const char * p_str, uint32_t max, cli_parse_status_t status, uint8_t offset,
+                       uint32_t value, int line)
+{
+    uint32_t parsed = 0xA5A5A5A5;
+    cli_parse_result_t res = cli_parse_uint(p_str, 0, max, &parsed);
+
+    test_check_eq(res.status, status, p_str, __FILE__, line);
+    test_check_eq(res.offset, offset, p_str, __FILE__, line);
+    // При ошибке значение не меняется
+    test_check_eq(parsed, (status == CLI_PARSE_OK) ? value : 0xA5A5A5A5, p_str, __FILE__, line);
+}
+
+#define UINT_OK(str, max, value)            uint_check(str, max, CLI_PARSE_OK, 0, value, __LINE__)
+#define UINT_ERR(str, max, status, offset)  uint_check(str, max, status, offset, 0, __LINE__)
+
+static void color_check(const char * p_str, cli_parse_status_t status, uint8_t offset, int line)
+{
+    uint8_t r = 1, g = 2, b = 3;
+    cli_parse_result_t res = cli_parse_color(p_str, &r, &g, &b);
+
+    test_check_eq(res.status, status, p_str, __FILE__, line);
+    test_check_eq(res.offset, offset, p_str, __FILE__, line);
+    if (status != CLI_PARSE_OK)
+    {
+        test_check((r == 1) && (g == 2) && (b == 3), p_str, __FILE__, line);
+    }
+}
+
+#define COLOR_ERR(str, status, offset)      color_check(str, status, offset, __LINE__)
+
+static uint32_t m_seed = 1;
+
+// Детерминированный ГПСЧ: результат повторяется от запуска к запуску
+static uint32_t fuzz_rand(void)
+{
+    m_seed = m_seed * 1103515245u + 12345u;
+    return m_seed >> 8;
+}
+
+static void fuzz_string(char * p_str, const char * p_alphabet)
+{
+    size_t alphabet_len = strlen(p_alphabet);
+    size_t length = fuzz_rand() % (FUZZ_LEN_MAX + 1);
+
+    // Чаще с префиксом 0x, иначе шестнадцатеричные строки почти не встречаются
+    size_t i = 0;
+    if ((length >= 2) && ((fuzz_rand() & 3) == 0))
+    {
+        p_str[i++] = '0';
+        p_str[i++] = 'x';
+    }
+    for (; i < length; i++)
+    {
+        p_str[i] = p_alphabet[fuzz_rand() % alphabet_len];
+    }
+    p_str[length] = '\0';
+}
+
+// Эталон на strtoull: цифры основания после необязательного 0x, значение до UINT32_MAX
+static bool uint_reference(const char * p_str, uint32_t * p_value)
+{
+    size_t i = 0;
+    int base = 10;
+
+    if ((p_str[0] == '0') && ((p_str[1] == 'x') || (p_str[1] == 'X')))
+    {
+        base = 16;
+        i = 2;
+    }
+    if (p_str[i] == '\0') return false;
+    if (strspn(&p_str[i], (base == 16) ? "0123456789abcdefABCDEF" : "0123456789") != strlen(&p_str[i]))
+    {
+        return false;
+    }
+
+    errno = 0;
+    unsigned long long value = strtoull(&p_str[i], NULL, base);
+    if ((errno != 0) || (value > UINT32_MAX)) return false;
+
+    *p_value = (uint32_t)value;
+    return true;
+}
+
+static void uint_fuzz(void)
+{
+    char str[FUZZ_LEN_MAX + 1];
+    uint32_t mismatches = 0;
+
+    for (uint32_t n = 0; n < FUZZ_COUNT; n++)
+    {
+        fuzz_string(str, "0123456789abcdefABCDEFxX#+- ");
+
+        uint32_t expected = 0;
+        uint32_t value = 0xA5A5A5A5;
+        bool ok = uint_reference(str, &expected);
+        cli_parse_result_t res = cli_parse_uint(str, 0, UINT32_MAX, &value);
+
+        if ((res.status == CLI_PARSE_OK) != ok ||
+            (ok && (value != expected)) ||
+            (!ok && (value != 0xA5A5A5A5)) ||
+            (res.offset > strlen(str)))
+        {
+            if (mismatches++ < 5)
+            {
+                test_check(false, str, __FILE__, __LINE__);
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+static void color_fuzz(void)
+{
+    char str[FUZZ_LEN_MAX + 1];
+    uint32_t mismatches = 0;
+
+    for (uint32_t n = 0; n < FUZZ_COUNT; n++)
+    {
+        fuzz_string(str, "0123456789abcdefABCDEFgG#x ");
+        // Чаще ровно "#" и 6 символов
+        if ((fuzz_rand() & 1) != 0)
+        {
+            str[0] = '#';
+            str[7] = '\0';
+            for (size_t i = strlen(str); i < 7; i++)
+            {
+                str[i] = "0123456789abcdef"[fuzz_rand() % 16];
+            }
+        }
+
+        bool ok = (strlen(str) == 7) && (str[0] == '#') &&
+                  (strspn(&str[1], "0123456789abcdefABCDEF") == 6);
+        uint8_t r = 0, g = 0, b = 0;
+        cli_parse_result_t res = cli_parse_color(str, &r, &g, &b);
+
+        uint32_t expected = ok ? (uint32_t)strtoul(&str[1], NULL, 16) : 0;
+        if ((res.status == CLI_PARSE_OK) != ok ||
+            (ok && (((uint32_t)r << 16 | (uint32_t)g << 8 | b) != expected)))
+        {
+            if (mismatches++ < 5)
+            {
+                test_check(false, str, __FILE__, __LINE__);
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+void test_cli_parse(void)
+{
+    UINT_OK("0", 255, 0);
+    UINT_OK("255", 255, 255);
+    UINT_OK("0xFF", 255, 255);
+    UINT_OK("0Xff", 255, 255);
+    UINT_OK("007", 255, 7);
+    UINT_OK("4294967295", UINT32_MAX, UINT32_MAX);
+    UINT_OK("0xFFFFFFFF", UINT32_MAX, UINT32_MAX);
+
+    UINT_ERR("256", 255, CLI_PARSE_OUT_OF_RANGE, 0);
+    UINT_ERR("12a", 255, CLI_PARSE_INVALID_CHAR, 2);
+    UINT_ERR("0x", 255, CLI_PARSE_EMPTY, 2);
+    UINT_ERR("0xG1", 255, CLI_PARSE_INVALID_CHAR, 2);
+
+    uint32_t value;
+    CHECK_EQ(cli_parse_uint("5", 10, 20, &value).status, CLI_PARSE_OUT_OF_RANGE);
+
+    uint8_t r = 0, g = 0, b = 0;
+    CHECK_EQ(cli_parse_color("#12abEF", &r, &g, &b).status, CLI_PARSE_OK);
+    CHECK_EQ(r, 0x12);
+    CHECK_EQ(g, 0xAB);
+    CHECK_EQ(b, 0xEF);
+    CHECK_EQ(cli_parse_color("12abEF", &r, &g, &b).status, CLI_PARSE_BAD_LENGTH);
+    CHECK_EQ(cli_parse_color("#12xbEF", &r, &g, &b).offset, 3);
+
+    // Границы 32 бит
+    UINT_ERR("4294967296", UINT32_MAX, CLI_PARSE_OVERFLOW, 9);
+    UINT_ERR("42949672950", UINT32_MAX, CLI_PARSE_OVERFLOW, 10);
+    UINT_ERR("0x100000000", UINT32_MAX, CLI_PARSE_OVERFLOW, 10);
+    UINT_ERR("99999999999999", UINT32_MAX, CLI_PARSE_OVERFLOW, 9);
+    UINT_OK("00000000004294967295", UINT32_MAX, UINT32_MAX);
+
+    // Пустые значения
+    UINT_ERR("", 255, CLI_PARSE_EMPTY, 0);
+    CHECK_EQ(cli_parse_uint(NULL, 0, 255, &value).status, CLI_PARSE_EMPTY);
+
+    // Знаки и пробелы не принимаются
+    UINT_ERR("-1", 255, CLI_PARSE_INVALID_CHAR, 0);
+    UINT_ERR("+1", 255, CLI_PARSE_INVALID_CHAR, 0);
+    UINT_ERR("0x-1", 255, CLI_PARSE_INVALID_CHAR, 2);
+    UINT_ERR(" 1", 255, CLI_PARSE_INVALID_CHAR, 0);
+
+    // Мусор после числа
+    UINT_ERR("255 ", 255, CLI_PARSE_INVALID_CHAR, 3);
+    UINT_ERR("1.5", 255, CLI_PARSE_INVALID_CHAR, 1);
+    UINT_ERR("0xFFg", 255, CLI_PARSE_INVALID_CHAR, 4);
+    UINT_ERR("10#", 255, CLI_PARSE_INVALID_CHAR, 2);
+
+    // Цвет не из 6 цифр
+    COLOR_ERR("#12345", CLI_PARSE_BAD_LENGTH, 6);
+    COLOR_ERR("#1234567", CLI_PARSE_BAD_LENGTH, 7);
+    COLOR_ERR("#12345 ", CLI_PARSE_INVALID_CHAR, 6);
+    COLOR_ERR("#", CLI_PARSE_EMPTY, 1);
+    COLOR_ERR("", CLI_PARSE_BAD_LENGTH, 0);
+    COLOR_ERR("#-12345", CLI_PARSE_INVALID_CHAR, 1);
+    CHECK_EQ(cli_parse_color(NULL, &r, &g, &b).status, CLI_PARSE_BAD_LENGTH);
+
+    uint_fuzz();
+    color_fuzz();
+
+    CHECK(cli_parse_status_str(CLI_PARSE_OVERFLOW)[0] != '\0');
+    CHECK(cli_parse_status_str((cli_parse_status_t)100)[0] != '\0');
+}
@@ -0,0 +1,52 @@
+#include "test.h"
+#include <stdio.h>
+
+static uint32_t m_checks;
+static uint32_t m_failures;
+
+bool test_check(bool ok, const char * p_expr, const char * p_file, int line)
+{
+    m_checks++;
+    if (!ok)
+    {
+        m_failures++;
+        printf("%s:%d: FAIL %s\n", p_file, line, p_expr);
+    }
+    return ok;
+}
+
+bool test_check_eq(long long actual, long long expected, const char * p_expr, const char * p_file, int line)
+{
+    m_checks++;
+    if (actual != expected)
+    {
+        m_failures++;
+        printf("%s:%d: FAIL %s (%lld != %lld)\n", p_file, line, p_expr, actual, expected);
+        return false;
+    }
+    return true;
+}
+
+static void group_run(const char * p_name, void (*group)(void))
+{
+    uint32_t failures = m_failures;
+
+    group();
+    printf("%-12s %s\n", p_name, (m_failures == failures) ? "ok" : "FAILED");
+}
+
+int main(void)
+{
+    test_platform_init();
+
+    group_run("cli_parse", test_cli_parse);
+    group_run("bin_proto", test_bin_proto);
+    group_run("render", test_render);
+    group_run("app_logic", test_app_logic);
+    group_run("button", test_button);
+    group_run("ws2812", test_ws2812);
+    group_run("usb_cli", test_usb_cli);
+
+    printf("%u checks, %u failed\n", (unsigned)m_checks, (unsigned)m_failures);
+    return (m_failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+#include "test.h"
+#include "sim.h"
+#include "app_timer.h"
+#include "nrf_pwr_mgmt.h"
+#include "button_handler.h"
+#include "pwm_handler.h"
+#include "ws2812_handler.h"
+#include "app_logic.h"
+#include "event_queue.h"
+#include "trace.h"
+#include "crc16.h"
+#include <string.h>
+
+static const int id_digits[4] = { 6, 6, 0, 6 };
+
+static const uint32_t led_pins[4] = { 6, 8, 41, 12 };
+
+static const uint32_t button_pins[] = { TEST_BUTTON_PIN };
+
+static const button_config_t button_config = {
+    .p_pins    = button_pins,
+    .pin_count = ARRAY_SIZE(button_pins),
+};
+
+void test_platform_init(void)
+{
+    nrf_pwr_mgmt_init();
+    app_timer_init();
+    event_queue_init();
+    pwm_handler_init(led_pins);
+    ws2812_handler_init(TEST_WS2812_PIN, TEST_WS2812_PIXELS);
+    button_handler_init(&button_config);
+    trace_init();
+    app_logic_init(id_digits);
+}
+
+void test_run_ms(uint32_t ms)
+{
+    uint64_t end_us = sim_time_us() + (uint64_t)ms * 1000;
+
+    // Без сна до следующего таймера: тест сам отмеряет время
+    while (sim_time_us() < end_us)
+    {
+        sim_wake();
+        nrf_pwr_mgmt_run();
+    }
+}
+
+// COBS хоста - отдельная от bin_proto.c реализация
+static size_t cobs_encode(uint8_t const * p_src, size_t length, uint8_t * p_dst)
+{
+    size_t  code_pos = 0;
+    size_t  out = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (p_src[i] != 0)
+        {
+            p_dst[out++] = p_src[i];
+            code++;
+        }
+        if ((p_src[i] == 0) || (code == 0xFF))
+        {
+            p_dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        }
+    }
+    p_dst[code_pos] = code;
+    return out;
+}
+
+size_t test_frame_build(uint8_t seq, uint8_t cmd, uint8_t const * p_data, size_t length,
+                        uint16_t crc_xor, uint8_t * p_frame)
+{
+    uint8_t raw[TEST_FRAME_MAX];
+
+    raw[0] = seq;
+    raw[1] = cmd;
+    if (length != 0)
+    {
+        memcpy(&raw[2], p_data, length);
+    }
+    length += 2;
+    uint16_t crc = crc16_compute(raw, length, NULL) ^ crc_xor;
+    raw[length++] = crc & 0xFF;
+    raw[length++] = crc >> 8;
+
+    p_frame[0] = 0;
+    size_t frame_len = 1 + cobs_encode(raw, length, &p_frame[1]);
+    p_frame[frame_len++] = 0;
+    return frame_len;
+}
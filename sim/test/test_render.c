@@ -0,0 +1,75 @@
+#include "test.h"
+#include "sim.h"
+#include "app_logic.h"
+#include "pwm_handler.h"
+
+// Цвет HSV на выходе ШИМ: R, G, B на шкале 0-1000, индикатор погашен
+static void hsv_check(uint16_t h, uint8_t s, uint8_t v, uint16_t r, uint16_t g, uint16_t b, int line)
+{
+    uint16_t out[4];
+
+    app_logic_show_hsv(h, s, v);
+    // Перезапуск после остановки завершается событием STOPPED
+    test_run_ms(1);
+    sim_pwm_output(TEST_PWM_LEDS, out);
+
+    test_check_eq(out[0], 0, "indicator", __FILE__, line);
+    test_check_eq(out[1], r, "r", __FILE__, line);
+    test_check_eq(out[2], g, "g", __FILE__, line);
+    test_check_eq(out[3], b, "b", __FILE__, line);
+}
+
+#define HSV_CHECK(h, s, v, r, g, b)     hsv_check(h, s, v, r, g, b, __LINE__)
+
+void test_render(void)
+{
+    app_logic_render_stats_t stats;
+
+    HSV_CHECK(0, 100, 100, 1000, 0, 0);
+    HSV_CHECK(60, 100, 100, 1000, 1000, 0);
+    HSV_CHECK(120, 100, 100, 0, 1000, 0);
+    HSV_CHECK(240, 100, 50, 0, 0, 500);
+    HSV_CHECK(300, 100, 100, 1000, 0, 1000);
+    HSV_CHECK(360, 100, 100, 1000, 0, 0);
+    HSV_CHECK(0, 0, 50, 500, 500, 500);
+
+    // Все погашено - ШИМ остановлен, затем снова запускается
+    HSV_CHECK(0, 100, 0, 0, 0, 0);
+    CHECK(!pwm_handler_is_running());
+    HSV_CHECK(120, 100, 100, 0, 1000, 0);
+    CHECK(pwm_handler_is_running());
+#if !ESTC_TRACE_ENABLED
+    // Циклическое воспроизведение без прерываний: простой не прерывается LOOPSDONE
+    CHECK(!sim_pwm_pending());
+#endif
+
+    // Тот же цвет - без пересчета и записи в ШИМ
+    app_logic_get_render_stats(&stats, true);
+    app_logic_show_hsv(120, 100, 100);
+    app_logic_get_render_stats(&stats, true);
+    CHECK_EQ(stats.hits, 1);
+    CHECK_EQ(stats.misses, 0);
+    CHECK_EQ(stats.pwm_writes, 0);
+
+    // Другой HSV с тем же заполнением: пересчет без записи
+    app_logic_show_hsv(0, 100, 0);
+    app_logic_show_hsv(200, 50, 0);
+    app_logic_get_render_stats(&stats, true);
+    CHECK_EQ(stats.misses, 2);
+    CHECK_EQ(stats.pwm_writes, 1);
+
+    // После вывода в обход app_logic тот же цвет записывается снова
+    app_logic_render_invalidate();
+    app_logic_show_hsv(200, 50, 0);
+    app_logic_get_render_stats(&stats, true);
+    CHECK_EQ(stats.pwm_writes, 1);
+
+    // RGB 0-1000 -> HSV -> тот же RGB
+    uint16_t out[4];
+    app_logic_show_rgb(1000, 500, 0);
+    test_run_ms(1);
+    sim_pwm_output(TEST_PWM_LEDS, out);
+    CHECK_EQ(out[1], 1000);
+    CHECK(out[2] >= 490 && out[2] <= 510);
+    CHECK_EQ(out[3], 0);
+}
@@ -0,0 +1,155 @@
+#include "test.h"
+#include "sim.h"
+#include "nrf_pwr_mgmt.h"
+#include "sdk_common.h"
+#include "usb_cli.h"
+#include "app_logic.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Ответ устройства, накопленный со стороны хоста pty
+static char   m_reply[1024];
+static size_t m_reply_len;
+static int    m_host = -1;
+
+// Основной цикл main.c: прерывания симулятора и разбор команд
+static void cli_run_ms(uint32_t ms)
+{
+    uint64_t end_us = sim_time_us() + (uint64_t)ms * 1000;
+
+    while (sim_time_us() < end_us)
+    {
+        sim_wake();
+        nrf_pwr_mgmt_run();
+        usb_cli_process();
+
+        ssize_t cnt = read(m_host, &m_reply[m_reply_len], sizeof(m_reply) - 1 - m_reply_len);
+        if (cnt > 0)
+        {
+            m_reply_len += (size_t)cnt;
+            m_reply[m_reply_len] = '\0';
+        }
+    }
+}
+
+static void host_send(const char * p_text)
+{
+    m_reply_len = 0;
+    m_reply[0]  = '\0';
+    CHECK_EQ(write(m_host, p_text, strlen(p_text)), strlen(p_text));
+    cli_run_ms(20);
+}
+
+// Красный канал светодиода
+static uint16_t led_red(void)
+{
+    uint16_t out[4];
+
+    sim_pwm_output(TEST_PWM_LEDS, out);
+    return out[1];
+}
+
+// Пакет нулевой длины не занимает блок приема и не останавливает разбор
+static void zlp_test(void)
+{
+    host_send("RGB 0 0 0\n");
+    CHECK_EQ(led_red(), 0);
+
+    CHECK(sim_cdc_acm_rx_zlp());
+    CHECK(sim_cdc_acm_rx_zlp());
+    cli_run_ms(5);
+
+    host_send("RGB 255 0 0\n");
+    CHECK(strstr(m_reply, "Color set to R=255") != NULL);
+    CHECK_EQ(led_red(), 1000);
+}
+
+static uint32_t flash_words(void)
+{
+    app_logic_flash_stats_t stats;
+
+    app_logic_get_flash_stats(&stats);
+    return stats.words_written;
+}
+
+// Пакет команд через ';' сохраняется во Flash в конце строки, в том числе
+// когда строка заканчивается разделителем: иначе запись откладывается
+// до следующей строки
+static void batch_test(void)
+{
+    static const char * const lines[] = {
+        "RGB 10 0 0;RGB 20 0 0\n",
+        "RGB 30 0 0;\n",
+        "RGB 40 0 0;\r\n",
+        "RGB 50 0 0;RGB 60 0 0;\r",
+    };
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(lines); i++)
+    {
+        uint32_t words = flash_words();
+
+        host_send(lines[i]);
+        CHECK(flash_words() > words);
+
+        // Следующая строка - одиночная команда, сохраняется сразу
+        words = flash_words();
+        host_send("RGB 0 0 0\n");
+        CHECK(flash_words() > words);
+        CHECK_EQ(led_red(), 0);
+    }
+}
+
+// Пока идет поток, кнопки и команды не пишут в ШИМ: по окончании потока
+// остается его последний цвет
+static void stream_test(void)
+{
+    uint16_t streamed[4];
+    uint16_t out[4];
+
+    host_send("stream 100 1\n");
+    CHECK(strstr(m_reply, "Streaming at 100 Hz") != NULL);
+
+    // Кадр R G B 0xFF; без следующих кадров цвет продолжается и через
+    // STREAM_EXTRAPOLATE_MAX выводов фиксируется
+    host_send("\x7f\x20\x10\xff");
+    cli_run_ms(100);
+    sim_pwm_output(TEST_PWM_LEDS, streamed);
+    CHECK(streamed[1] > 0);
+
+    // Запись видна сразу, до следующего вывода кадра потока
+    app_logic_set_hsv(240, 100, 100);
+    sim_pwm_output(TEST_PWM_LEDS, out);
+    CHECK_EQ(out[1], streamed[1]);
+    CHECK_EQ(out[3], streamed[3]);
+
+    // Лишний 0xFF завершает поток. Цвет потока становится текущим HSV,
+    // заполнение - с точностью пересчета
+    host_send("\xff");
+    sim_pwm_output(TEST_PWM_LEDS, out);
+    for (uint32_t i = 1; i < 4; i++)
+    {
+        CHECK(abs((int)out[i] - (int)streamed[i]) <= 10);
+    }
+
+    host_send("RGB 0 0 0\n");
+    CHECK_EQ(led_red(), 0);
+}
+
+void test_usb_cli(void)
+{
+    usb_cli_init();
+    m_host = sim_cdc_acm_host_open();
+    CHECK(m_host >= 0);
+    if (m_host < 0) return;
+
+    // Порт открывается в следующем проходе цикла
+    cli_run_ms(20);
+
+    zlp_test();
+    batch_test();
+    stream_test();
+
+    close(m_host);
+    cli_run_ms(5);
+}
@@ -0,0 +1,87 @@
+#include "test.h"
+#include "sim.h"
+#include "ws2812_handler.h"
+
+#define BIT_0       0x8006
+#define BIT_1       0x800D
+#define BIT_LOW     0x8000
+
+// Первые 24 значения потока: GRB старшим битом вперед
+static void pixel_check(uint16_t const * p_values, uint32_t grb, int line)
+{
+    uint32_t mismatches = 0;
+
+    for (uint32_t i = 0; i < 24; i++)
+    {
+        uint16_t expected = (grb & (1UL << (23 - i))) ? BIT_1 : BIT_0;
+        if (p_values[i] != expected) mismatches++;
+    }
+    test_check_eq(mismatches, 0, "pixel bits", __FILE__, line);
+}
+
+void test_ws2812(void)
+{
+    uint16_t const * p_values;
+    uint32_t length;
+    ws2812_stats_t stats;
+
+    // Кадр гашения из init выводится за первый проход
+    test_run_ms(1);
+    CHECK(!ws2812_handler_is_busy());
+    CHECK_EQ(ws2812_handler_length(), TEST_WS2812_PIXELS);
+    CHECK_EQ(ws2812_handler_frame_time_us(), 541);
+
+    ws2812_handler_fill(0, 0, 0);
+    ws2812_handler_set_pixel(0, 0x12, 0x34, 0x56);
+    ws2812_handler_set_pixel(TEST_WS2812_PIXELS, 0xFF, 0xFF, 0xFF);
+    ws2812_handler_show();
+    CHECK(ws2812_handler_is_busy());
+    CHECK(sim_pwm_sequence(TEST_PWM_WS2812, &p_values, &length));
+    CHECK_EQ(length, TEST_WS2812_PIXELS * 24 + 1);
+    pixel_check(&p_values[0], 0x341256, __LINE__);
+    pixel_check(&p_values[24], 0, __LINE__);
+    CHECK_EQ(p_values[length - 1], BIT_LOW);
+
+    // Во время передачи длина не меняется
+    CHECK(!ws2812_handler_set_length(4));
+
+    // Два кадра во время передачи: выводится последний, первый перезаписан
+    ws2812_handler_get_stats(&stats);
+    ws2812_handler_fill(0xFF, 0, 0);
+    ws2812_handler_show();
+    ws2812_handler_fill(0, 0, 0x80);
+    ws2812_handler_show();
+
+    ws2812_stats_t after;
+    ws2812_handler_get_stats(&after);
+    CHECK_EQ(after.frames_replaced - stats.frames_replaced, 1);
+    CHECK_EQ(after.frames_shown, stats.frames_shown);
+
+    // Конец кадра (STOPPED после остановки в конце последовательности) сразу
+    // запускает ожидающий
+    sim_pwm_process();
+    CHECK(ws2812_handler_is_busy());
+    CHECK(!sim_pwm_sequence(TEST_PWM_WS2812, &p_values, &length));
+    sim_pwm_process();
+    CHECK(ws2812_handler_is_busy());
+    CHECK(sim_pwm_sequence(TEST_PWM_WS2812, &p_values, &length));
+    pixel_check(&p_values[0], 0x000080, __LINE__);
+    pixel_check(&p_values[(TEST_WS2812_PIXELS - 1) * 24], 0x000080, __LINE__);
+    ws2812_handler_get_stats(&after);
+    CHECK_EQ(after.frames_shown - stats.frames_shown, 1);
+
+    test_run_ms(1);
+    CHECK(!ws2812_handler_is_busy());
+    CHECK(!sim_pwm_sequence(TEST_PWM_WS2812, &p_values, &length));
+
+    // Новая длина ограничена размером буферов
+    CHECK(ws2812_handler_set_length(WS2812_MAX_PIXELS + 1));
+    CHECK_EQ(ws2812_handler_length(), WS2812_MAX_PIXELS);
+    CHECK_EQ(ws2812_handler_frame_time_us(), (WS2812_MAX_PIXELS * 24 + 1 + 240) * 1250 / 1000);
+    ws2812_handler_show();
+    CHECK(sim_pwm_sequence(TEST_PWM_WS2812, &p_values, &length));
+    CHECK_EQ(length, WS2812_MAX_PIXELS * 24 + 1);
+
+    test_run_ms(1);
+    CHECK(ws2812_handler_set_length(TEST_WS2812_PIXELS));
+}
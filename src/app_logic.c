@@ -1,11 +1,18 @@
 #include "app_logic.h"
 #include "pwm_handler.h"
+#include "button_handler.h"
+#include "event_queue.h"
+#include "color_stream.h"
+#include "perf.h"
+#include "trace.h"
 #include "app_timer.h"
+#include "app_util_platform.h"
 #include "nrf_log.h"
 #include "nrfx_nvmc.h"
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
 
 // Параметры обновления
 #define VALUE_UPDATE_INTERVAL_MS    15
@@ -13,9 +20,18 @@
 #define SAT_STEP                    1
 #define VAL_STEP                    1
 
+// Кривые ускорения при удержании: {время удержания, мс; скорость, шагов/с}.
+// Между точками скорость меняется линейно, после последней - постоянна.
+// Полный круг Hue: ~2.5 с вместо 5.4 с; проход S/V: ~1.15 с вместо 1.5 с
+#define ACCEL_HUE_CURVE     { {0, 40}, {1000, 90}, {2000, 240} }
+#define ACCEL_SV_CURVE      { {0, 40}, {600, 80}, {1200, 160} }
+
 // Адрес страницы для сохранения настроек.
 #define FLASH_SAVE_ADDR             0x7F000
 
+// Признак записанной статистики (страницы старого формата ее не содержат)
+#define FLASH_STATS_MAGIC           0x57454152  // "WEAR"
+
 // Режимы работы
 typedef enum
 {
@@ -32,12 +48,48 @@ typedef struct
     app_logic_hsv_t current_color;
     uint32_t count;
     saved_color_entry_t list[MAX_SAVED_COLORS];
+    // Статистика - последней: в сравнении настроек не участвует
+    uint32_t stats_magic;
+    app_logic_flash_stats_t stats;
 } app_flash_data_t;
 
+// Размер настроек, сравниваемых перед сохранением
+#define FLASH_SETTINGS_SIZE         offsetof(app_flash_data_t, stats_magic)
+
+// Точка кривой ускорения
+typedef struct
+{
+    uint32_t hold_ms;
+    uint32_t steps_per_s;
+} accel_point_t;
+
+// Кэш последнего вывода на светодиоды
+typedef struct
+{
+    bool            valid;
+    app_logic_hsv_t hsv;        // Цвет, для которого рассчитаны значения
+    uint16_t        r, g, b;    // Значения заполнения ШИМ (0-1000)
+} render_cache_t;
+
 // Локальные переменные
 static app_flash_data_t m_app_data;          
+static render_cache_t   m_render;
+static app_logic_render_stats_t m_render_stats;
+static uint32_t         m_nvmc_time_us;       // Остаток времени записи меньше 1 мс
 static input_mode_t     m_current_mode = INPUT_MODE_NONE;
 static bool             m_is_holding = false;
+static volatile bool    m_tick_pending = false;
+static volatile bool    m_host_color_pending = false;
+static uint16_t         m_host_rgb[3];           // Последний цвет app_logic_post_rgb()
+static bool             m_batch_active = false;  // Идет пакет команд
+static bool             m_batch_dirty = false;   // В пакете было сохранение
+
+static const accel_point_t m_hue_curve[] = ACCEL_HUE_CURVE;
+static const accel_point_t m_sv_curve[]  = ACCEL_SV_CURVE;
+
+// Начало текущего удержания и уже выполненное число шагов
+static uint32_t         m_hold_start_us;
+static uint32_t         m_hold_steps_done;
 
 // Направление: 1 = вверх, -1 = вниз
 static int8_t       m_sat_direction = -1;
@@ -48,14 +100,44 @@ APP_TIMER_DEF(m_update_timer);
 // Сохранение всех данных в Flash
 static void save_all_data_to_flash(void)
 {
+    // Пакет команд: одна запись в конце пакета
+    if (m_batch_active)
+    {
+        m_batch_dirty = true;
+        return;
+    }
+
+    // Настройки не изменились -> страницу не стираем.
+    // Счетчик пропусков попадет во Flash со следующим сохранением
+    if (memcmp(&m_app_data, (void const *)FLASH_SAVE_ADDR, FLASH_SETTINGS_SIZE) == 0)
+    {
+        m_app_data.stats.commits_skipped++;
+        return;
+    }
+
+    PERF_BEGIN(FLASH_SAVE);
+    uint32_t start_us = button_handler_time_us();
+
+    // Записанная статистика уже учитывает это сохранение (кроме его времени)
+    m_app_data.stats_magic = FLASH_STATS_MAGIC;
+    m_app_data.stats.page_erases++;
+    m_app_data.stats.words_written += sizeof(m_app_data) / 4;
+
     nrfx_nvmc_page_erase(FLASH_SAVE_ADDR);
     nrfx_nvmc_words_write(FLASH_SAVE_ADDR, (uint32_t *)&m_app_data, sizeof(m_app_data) / 4);
     while (nrfx_nvmc_write_done_check() == false);
+
+    m_nvmc_time_us += button_handler_time_us() - start_us;
+    m_app_data.stats.nvmc_time_ms += m_nvmc_time_us / 1000;
+    m_nvmc_time_us %= 1000;
+    PERF_END(FLASH_SAVE);
 }
 
 // Конвертация RGB -> HSV
 static void rgb_to_hsv(uint16_t r, uint16_t g, uint16_t b, app_logic_hsv_t *hsv)
 {
+    PERF_BEGIN(RGB_TO_HSV);
+
     float R = r / 1000.0f;
     float G = g / 1000.0f;
     float B = b / 1000.0f;
@@ -84,11 +166,15 @@ static void rgb_to_hsv(uint16_t r, uint16_t g, uint16_t b, app_logic_hsv_t *hsv)
     }
 
     hsv->v = (uint8_t)(cmax * 100);
+
+    PERF_END(RGB_TO_HSV);
 }
 
 // Конвертация HSV -> RGB
 static void hsv_to_rgb(app_logic_hsv_t hsv, uint16_t *r, uint16_t *g, uint16_t *b)
 {
+    PERF_BEGIN(HSV_TO_RGB);
+
     float H = hsv.h;
     float S = hsv.s / 100.0f;
     float V = hsv.v / 100.0f;
@@ -116,14 +202,52 @@ static void hsv_to_rgb(app_logic_hsv_t hsv, uint16_t *r, uint16_t *g, uint16_t *
     *r = (uint16_t)((R_temp + m) * 1000);
     *g = (uint16_t)((G_temp + m) * 1000);
     *b = (uint16_t)((B_temp + m) * 1000);
+
+    PERF_END(HSV_TO_RGB);
 }
 
-// Обновление LED
+// Обновление LED (пересчет и запись в ШИМ только при изменении цвета).
+// Во время потока (color_stream) светодиоды принадлежат ему: цвет кнопки
+// или команды запоминается, а поток по окончании выводит свой последний
 static void update_leds(void)
 {
+    if (color_stream_is_active()) return;
+
+    PERF_BEGIN(UPDATE_LEDS);
+    TRACE(UPDATE_LEDS, 0, 0);
+
+    app_logic_hsv_t hsv = m_app_data.current_color;
+
+    if (m_render.valid &&
+        m_render.hsv.h == hsv.h && m_render.hsv.s == hsv.s && m_render.hsv.v == hsv.v)
+    {
+        m_render_stats.hits++;
+        PERF_END(UPDATE_LEDS);
+        return;
+    }
+    m_render_stats.misses++;
+
     uint16_t r, g, b;
-    hsv_to_rgb(m_app_data.current_color, &r, &g, &b);
+    hsv_to_rgb(hsv, &r, &g, &b);
+
+    m_render.hsv = hsv;
+
+    // Разные HSV могут дать одинаковое заполнение (например, при V = 0)
+    if (m_render.valid && m_render.r == r && m_render.g == g && m_render.b == b)
+    {
+        PERF_END(UPDATE_LEDS);
+        return;
+    }
+
+    m_render.r = r;
+    m_render.g = g;
+    m_render.b = b;
+    m_render.valid = true;
+
+    m_render_stats.pwm_writes++;
     pwm_handler_set_rgb(r, g, b);
+
+    PERF_END(UPDATE_LEDS);
 }
 
 // Смена режима
@@ -152,54 +276,115 @@ static void set_mode(input_mode_t new_mode)
     }
 }
 
-// Таймер изменения значений
+// Таймер изменения значений: только передает тик в основной цикл
 static void update_timer_handler(void * p_context)
+{
+    // Необработанный тик уже в очереди -> не дублируем
+    if (m_tick_pending) return;
+
+    PERF_BEGIN(TMR_UPDATE);
+    app_event_t event = {
+        .type         = APP_EVENT_UPDATE_TICK,
+        .timestamp_us = button_handler_time_us()
+    };
+    m_tick_pending = event_queue_put(&event);
+    PERF_END(TMR_UPDATE);
+}
+
+// Расстояние (в тысячных долях шага), пройденное за hold_ms удержания.
+// Интеграл кусочно-линейной кривой скорости; после последней точки скорость постоянна
+static uint64_t accel_distance(accel_point_t const * p_curve, uint32_t points, uint32_t hold_ms)
+{
+    uint64_t distance = 0;
+
+    for (uint32_t i = 0; i + 1 < points; i++)
+    {
+        if (hold_ms <= p_curve[i].hold_ms) return distance;
+
+        uint32_t t0 = p_curve[i].hold_ms;
+        uint32_t t1 = p_curve[i + 1].hold_ms;
+        uint32_t v0 = p_curve[i].steps_per_s;
+        uint32_t v1 = p_curve[i + 1].steps_per_s;
+
+        // Отрезок пройден частично -> скорость в точке hold_ms
+        if (hold_ms < t1)
+        {
+            v1 = v0 + (v1 - v0) * (hold_ms - t0) / (t1 - t0);
+            t1 = hold_ms;
+        }
+
+        // Площадь трапеции: (v0 + v1) / 2 [шаг/с] * (t1 - t0) [мс] = тысячные доли шага
+        distance += (uint64_t)(v0 + v1) * (t1 - t0) / 2;
+    }
+
+    accel_point_t const * p_last = &p_curve[points - 1];
+    if (hold_ms > p_last->hold_ms)
+    {
+        distance += (uint64_t)p_last->steps_per_s * (hold_ms - p_last->hold_ms);
+    }
+    return distance;
+}
+
+// Шаги маятника с разворотом на границах 0 и 100
+static uint8_t pendulum_advance(uint8_t value, int8_t * p_direction, uint8_t step, uint32_t steps)
+{
+    int16_t new_value = value;
+
+    // Полный цикл 0 -> 100 -> 0 не меняет состояние
+    steps %= (2 * 100 / step);
+
+    while (steps--)
+    {
+        new_value += *p_direction * step;
+
+        if (new_value >= 100)
+        {
+            new_value = 100;
+            *p_direction = -1; // Разворачиваем вниз
+        }
+        else if (new_value <= 0)
+        {
+            new_value = 0;
+            *p_direction = 1;  // Разворачиваем вверх
+        }
+    }
+    return (uint8_t)new_value;
+}
+
+// Изменение значений при удержании кнопки.
+// Число шагов считается по времени удержания, поэтому пропущенные
+// или объединенные тики не влияют на итоговую скорость.
+static void on_update_tick(uint32_t timestamp_us)
 {
     if (!m_is_holding || m_current_mode == INPUT_MODE_NONE) return;
 
+    uint32_t hold_ms = (timestamp_us - m_hold_start_us) / 1000;
+
+    accel_point_t const * p_curve = (m_current_mode == INPUT_MODE_HUE) ? m_hue_curve : m_sv_curve;
+    uint32_t points = (m_current_mode == INPUT_MODE_HUE) ? ARRAY_SIZE(m_hue_curve) : ARRAY_SIZE(m_sv_curve);
+
+    uint32_t total_steps = (uint32_t)(accel_distance(p_curve, points, hold_ms) / 1000);
+    uint32_t steps = total_steps - m_hold_steps_done;
+    if (steps == 0) return;
+    m_hold_steps_done = total_steps;
+
     switch (m_current_mode)
     {
         case INPUT_MODE_HUE:
             // Hue (0-360)
-            m_app_data.current_color.h = (m_app_data.current_color.h + HUE_STEP) % 360;
+            m_app_data.current_color.h = (m_app_data.current_color.h + (steps % 360) * HUE_STEP) % 360;
             break;
 
         case INPUT_MODE_SAT:
             // Логика маятника для Saturation
-            {
-                int16_t new_sat = m_app_data.current_color.s + (m_sat_direction * SAT_STEP);
-                
-                if (new_sat >= 100)
-                {
-                    new_sat = 100;
-                    m_sat_direction = -1; // Разворачиваем вниз
-                }
-                else if (new_sat <= 0)
-                {
-                    new_sat = 0;
-                    m_sat_direction = 1;  // Разворачиваем вверх
-                }
-                m_app_data.current_color.s = (uint8_t)new_sat;
-            }
+            m_app_data.current_color.s = pendulum_advance(m_app_data.current_color.s,
+                                                          &m_sat_direction, SAT_STEP, steps);
             break;
 
         case INPUT_MODE_VAL:
             // Логика маятника для Value (Яркость)
-            {
-                int16_t new_val = m_app_data.current_color.v + (m_val_direction * VAL_STEP);
-                
-                if (new_val >= 100)
-                {
-                    new_val = 100;
-                    m_val_direction = -1; // Разворачиваем вниз
-                }
-                else if (new_val <= 0)
-                {
-                    new_val = 0;
-                    m_val_direction = 1;  // Разворачиваем вверх
-                }
-                m_app_data.current_color.v = (uint8_t)new_val;
-            }
+            m_app_data.current_color.v = pendulum_advance(m_app_data.current_color.v,
+                                                          &m_val_direction, VAL_STEP, steps);
             break;
 
         default: break;
@@ -208,25 +393,78 @@ static void update_timer_handler(void * p_context)
 }
 
 // Обработка событий кнопки
-void app_logic_on_button_event(button_event_t event)
+static void on_button_event(uint8_t id, button_event_t event, uint32_t timestamp_us)
 {
+    NRF_LOG_DEBUG("Button %d event %d at %u us", id, event, timestamp_us);
+    TRACE(APP_EVENT, id, event);
+
+    // Управление цветом - только с основной кнопки
+    if (id != 0) return;
+
     switch (event)
     {
         case BUTTON_EVENT_DOUBLE_CLICK:
             set_mode((m_current_mode + 1) % INPUT_MODE_COUNT);
             break;
 
-        case BUTTON_EVENT_PRESSED:
+        case BUTTON_EVENT_LONG_PRESS:
+            // Отсчет ускорения ведем от распознавания удержания, без скачка на пороге
             m_is_holding = true;
+            m_hold_start_us = button_handler_time_us();
+            m_hold_steps_done = 0;
             if (m_current_mode != INPUT_MODE_NONE) {
                 app_timer_start(m_update_timer, APP_TIMER_TICKS(VALUE_UPDATE_INTERVAL_MS), NULL);
             }
             break;
 
+        case BUTTON_EVENT_HOLD_REPEAT:
+            // Шаги считаются по времени: повтор догоняет цвет до своей метки,
+            // даже если тик таймера обновления пропущен
+            on_update_tick(timestamp_us);
+            break;
+
         case BUTTON_EVENT_RELEASED:
             m_is_holding = false;
             app_timer_stop(m_update_timer);
             break;
+
+        default: break;
+    }
+}
+
+// Разбор очереди событий
+void app_logic_process(void)
+{
+    app_event_t event;
+
+    while (event_queue_get(&event))
+    {
+        switch (event.type)
+        {
+            case APP_EVENT_BUTTON:
+                on_button_event(event.id, (button_event_t)event.arg, event.timestamp_us);
+                break;
+
+            case APP_EVENT_UPDATE_TICK:
+                m_tick_pending = false;
+                on_update_tick(event.timestamp_us);
+                break;
+
+            case APP_EVENT_HOST_COLOR:
+            {
+                uint16_t rgb[3];
+
+                CRITICAL_REGION_ENTER();
+                memcpy(rgb, m_host_rgb, sizeof(rgb));
+                m_host_color_pending = false;
+                CRITICAL_REGION_EXIT();
+
+                app_logic_show_rgb(rgb[0], rgb[1], rgb[2]);
+                break;
+            }
+
+            default: break;
+        }
     }
 }
 
@@ -250,6 +488,11 @@ void app_logic_init(const int *id_digits)
     else
     {
         memcpy(&m_app_data, p_flash, sizeof(app_flash_data_t));
+        if (m_app_data.stats_magic != FLASH_STATS_MAGIC)
+        {
+            // Страница старого формата: статистика начинается с нуля
+            memset(&m_app_data.stats, 0, sizeof(m_app_data.stats));
+        }
         if (m_app_data.current_color.h > 360) m_app_data.current_color.h = 0;
         if (m_app_data.current_color.s > 100) m_app_data.current_color.s = 100;
         if (m_app_data.current_color.v > 100) m_app_data.current_color.v = 100;
@@ -260,35 +503,99 @@ void app_logic_init(const int *id_digits)
 
     app_timer_create(&m_update_timer, APP_TIMER_MODE_REPEATED, update_timer_handler);
 
+    m_render.valid = false;
+
     set_mode(INPUT_MODE_NONE);
     update_leds();
 }
 
-// Установка HSV
-void app_logic_set_hsv(uint16_t h, uint8_t s, uint8_t v)
+// Показ HSV без сохранения во Flash
+void app_logic_show_hsv(uint16_t h, uint8_t s, uint8_t v)
 {
     m_app_data.current_color.h = (h > 360) ? 360 : h;
     m_app_data.current_color.s = (s > 100) ? 100 : s;
     m_app_data.current_color.v = (v > 100) ? 100 : v;
 
-    set_mode(INPUT_MODE_NONE);
+    // Режим меняется только при выходе из редактирования: при потоке
+    // обновлений не трогаем индикатор и его таймер
+    if (m_current_mode != INPUT_MODE_NONE)
+        set_mode(INPUT_MODE_NONE);
     update_leds();
-    save_all_data_to_flash();
 }
 
-// Установка RGB
-void app_logic_set_rgb(uint16_t r, uint16_t g, uint16_t b)
+// Показ RGB без сохранения во Flash
+void app_logic_show_rgb(uint16_t r, uint16_t g, uint16_t b)
 {
     if (r > 1000) r = 1000;
     if (g > 1000) g = 1000;
     if (b > 1000) b = 1000;
 
-    set_mode(INPUT_MODE_NONE); 
+    if (m_current_mode != INPUT_MODE_NONE)
+        set_mode(INPUT_MODE_NONE);
     rgb_to_hsv(r, g, b, &m_app_data.current_color);
     update_leds();
+}
+
+void app_logic_post_rgb(uint16_t r, uint16_t g, uint16_t b)
+{
+    CRITICAL_REGION_ENTER();
+    m_host_rgb[0] = r;
+    m_host_rgb[1] = g;
+    m_host_rgb[2] = b;
+    if (!m_host_color_pending)
+    {
+        app_event_t event = {
+            .type         = APP_EVENT_HOST_COLOR,
+            .timestamp_us = button_handler_time_us()
+        };
+        m_host_color_pending = event_queue_put(&event);
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+// Установка HSV
+void app_logic_set_hsv(uint16_t h, uint8_t s, uint8_t v)
+{
+    app_logic_show_hsv(h, s, v);
+    save_all_data_to_flash();
+}
+
+// Установка RGB
+void app_logic_set_rgb(uint16_t r, uint16_t g, uint16_t b)
+{
+    app_logic_show_rgb(r, g, b);
     save_all_data_to_flash();
 }
 
+void app_logic_save(void)
+{
+    save_all_data_to_flash();
+}
+
+void app_logic_get_current(app_logic_hsv_t * p_color)
+{
+    *p_color = m_app_data.current_color;
+}
+
+void app_logic_batch_begin(void)
+{
+    m_batch_active = true;
+}
+
+void app_logic_batch_end(void)
+{
+    m_batch_active = false;
+    if (m_batch_dirty)
+    {
+        m_batch_dirty = false;
+        save_all_data_to_flash();
+    }
+}
+
+void app_logic_render_invalidate(void)
+{
+    m_render.valid = false;
+}
 
 bool app_logic_save_color_hsv(uint16_t h, uint8_t s, uint8_t v, const char * name)
 {
@@ -371,4 +678,18 @@ const saved_color_entry_t * app_logic_get_list(uint8_t * count)
 {
     *count = (uint8_t)m_app_data.count;
     return m_app_data.list;
-}
\ No newline at end of file
+}
+
+void app_logic_get_render_stats(app_logic_render_stats_t * p_stats, bool reset)
+{
+    *p_stats = m_render_stats;
+    if (reset)
+    {
+        memset(&m_render_stats, 0, sizeof(m_render_stats));
+    }
+}
+
+void app_logic_get_flash_stats(app_logic_flash_stats_t * p_stats)
+{
+    *p_stats = m_app_data.stats;
+}
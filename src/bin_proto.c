@@ -0,0 +1,315 @@
+#include "bin_proto.h"
+
+#include <string.h>
+
+#if ESTC_USB_CLI_ENABLED
+
+#include "app_logic.h"
+#include "crc16.h"
+
+#define FRAME_DELIMITER     0x00
+#define RESPONSE_FLAG       0x80
+
+// Заголовок seq + cmd и CRC
+#define FRAME_HEADER_LEN    2
+#define FRAME_CRC_LEN       2
+
+// Декодированный кадр всегда короче закодированного
+#define MAX_DECODED         BIN_PROTO_MAX_ENCODED
+
+// Ответ: seq, cmd, status, данные, CRC
+#define MAX_RESPONSE        (FRAME_HEADER_LEN + 1 + BIN_PROTO_MAX_REPLY + FRAME_CRC_LEN)
+
+typedef enum
+{
+    RX_TEXT,        // Байты идут в CLI
+    RX_FRAME,       // Внутри двоичного кадра
+    RX_DISCARD      // Кадр слишком длинный, ждем разделитель
+} rx_state_t;
+
+static bin_proto_write_t m_write;
+static rx_state_t        m_state = RX_TEXT;
+static uint8_t           m_rx_buf[BIN_PROTO_MAX_ENCODED];
+static uint32_t          m_rx_len;
+static uint8_t           m_expected_seq;
+static bool              m_seq_valid = false;
+static bin_proto_stats_t m_stats;
+
+// Декодирование COBS. Возвращает длину или 0 при ошибке
+static uint32_t cobs_decode(uint8_t const * p_src, uint32_t length, uint8_t * p_dst)
+{
+    uint32_t out = 0;
+    uint32_t i = 0;
+
+    while (i < length)
+    {
+        uint8_t code = p_src[i++];
+        if (code == 0 || i + code - 1 > length) return 0;
+
+        for (uint32_t j = 1; j < code; j++)
+        {
+            p_dst[out++] = p_src[i++];
+        }
+        // Блок короче 0xFF заканчивается нулем, кроме последнего
+        if (code != 0xFF && i < length)
+        {
+            p_dst[out++] = 0;
+        }
+    }
+    return out;
+}
+
+// Кодирование COBS. Возвращает длину результата
+static uint32_t cobs_encode(uint8_t const * p_src, uint32_t length, uint8_t * p_dst)
+{
+    uint32_t code_pos = 0;
+    uint32_t out = 1;
+    uint8_t  code = 1;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (p_src[i] == 0)
+        {
+            p_dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+            continue;
+        }
+
+        p_dst[out++] = p_src[i];
+        if (++code == 0xFF)
+        {
+            p_dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        }
+    }
+    p_dst[code_pos] = code;
+    return out;
+}
+
+static void send_response(uint8_t seq, uint8_t cmd, bin_proto_status_t status,
+                          uint8_t const * p_data, uint32_t length)
+{
+    uint8_t frame[MAX_RESPONSE];
+    uint8_t encoded[MAX_RESPONSE + 4];
+
+    frame[0] = seq;
+    frame[1] = cmd | RESPONSE_FLAG;
+    frame[2] = status;
+    memcpy(&frame[3], p_data, length);
+    length += 3;
+
+    uint16_t crc = crc16_compute(frame, length, NULL);
+    frame[length++] = crc & 0xFF;
+    frame[length++] = crc >> 8;
+
+    encoded[0] = FRAME_DELIMITER;
+    uint32_t encoded_len = 1 + cobs_encode(frame, length, &encoded[1]);
+    encoded[encoded_len++] = FRAME_DELIMITER;
+
+    if ((m_write != NULL) && !m_write(encoded, encoded_len))
+    {
+        m_stats.tx_dropped++;
+    }
+}
+
+bin_proto_status_t bin_proto_execute(uint8_t cmd, uint8_t const * p_data, uint32_t data_len,
+                                     uint8_t * p_reply, uint32_t * p_reply_len)
+{
+    bin_proto_status_t status = BIN_STATUS_OK;
+    *p_reply_len = 0;
+
+    switch (cmd)
+    {
+        case BIN_CMD_SET_HSV:
+            if (data_len != 4)
+            {
+                status = BIN_STATUS_BAD_LENGTH;
+                break;
+            }
+            // Диапазоны как у команды HSV
+            if (((p_data[0] | (p_data[1] << 8)) > 360) || (p_data[2] > 100) || (p_data[3] > 100))
+            {
+                status = BIN_STATUS_BAD_ARG;
+                break;
+            }
+            app_logic_show_hsv(p_data[0] | (p_data[1] << 8), p_data[2], p_data[3]);
+            break;
+
+        case BIN_CMD_SET_RGB:
+            if (data_len != 3)
+            {
+                status = BIN_STATUS_BAD_LENGTH;
+                break;
+            }
+            // Масштабируем 0-255 -> 0-1000, как в команде RGB
+            app_logic_show_rgb(p_data[0] * 1000 / 255, p_data[1] * 1000 / 255, p_data[2] * 1000 / 255);
+            break;
+
+        case BIN_CMD_APPLY:
+        {
+            char name[COLOR_NAME_LEN];
+            if (data_len == 0 || data_len >= COLOR_NAME_LEN)
+            {
+                status = BIN_STATUS_BAD_LENGTH;
+                break;
+            }
+            memcpy(name, p_data, data_len);
+            name[data_len] = '\0';
+            if (!app_logic_apply_color(name))
+            {
+                status = BIN_STATUS_NOT_FOUND;
+            }
+            break;
+        }
+
+        case BIN_CMD_SAVE:
+            if (data_len != 0)
+            {
+                status = BIN_STATUS_BAD_LENGTH;
+                break;
+            }
+            app_logic_save();
+            break;
+
+        case BIN_CMD_QUERY:
+        {
+            if (data_len != 0)
+            {
+                status = BIN_STATUS_BAD_LENGTH;
+                break;
+            }
+            app_logic_hsv_t color;
+            uint8_t count;
+            app_logic_get_current(&color);
+            app_logic_get_list(&count);
+
+            p_reply[0] = color.h & 0xFF;
+            p_reply[1] = color.h >> 8;
+            p_reply[2] = color.s;
+            p_reply[3] = color.v;
+            p_reply[4] = count;
+            *p_reply_len = 5;
+            break;
+        }
+
+        default:
+            status = BIN_STATUS_UNKNOWN_CMD;
+            break;
+    }
+
+    return status;
+}
+
+static void handle_frame(uint8_t const * p_frame, uint32_t length)
+{
+    uint8_t seq = p_frame[0];
+    uint8_t cmd = p_frame[1];
+
+    if (m_seq_valid && seq != m_expected_seq)
+    {
+        m_stats.seq_gaps++;
+    }
+    m_expected_seq = seq + 1;
+    m_seq_valid = true;
+
+    uint8_t reply[BIN_PROTO_MAX_REPLY];
+    uint32_t reply_len;
+    bin_proto_status_t status = bin_proto_execute(cmd, &p_frame[FRAME_HEADER_LEN], length - FRAME_HEADER_LEN,
+                                                  reply, &reply_len);
+
+    send_response(seq, cmd, status, reply, reply_len);
+}
+
+// Проверка и обработка принятого кадра
+static void process_frame(void)
+{
+    uint8_t frame[MAX_DECODED];
+    uint32_t length = cobs_decode(m_rx_buf, m_rx_len, frame);
+
+    if (length < FRAME_HEADER_LEN + FRAME_CRC_LEN)
+    {
+        m_stats.crc_errors++;
+        return;
+    }
+
+    length -= FRAME_CRC_LEN;
+    uint16_t crc = frame[length] | (frame[length + 1] << 8);
+    if (crc16_compute(frame, length, NULL) != crc)
+    {
+        // Ответа нет: хост повторяет кадр по таймауту
+        m_stats.crc_errors++;
+        return;
+    }
+
+    m_stats.frames++;
+    handle_frame(frame, length);
+}
+
+void bin_proto_init(bin_proto_write_t write)
+{
+    m_write = write;
+}
+
+bool bin_proto_rx_byte(uint8_t byte)
+{
+    switch (m_state)
+    {
+        case RX_TEXT:
+            if (byte != FRAME_DELIMITER) return false;
+            m_state = RX_FRAME;
+            m_rx_len = 0;
+            return true;
+
+        case RX_FRAME:
+            if (byte == FRAME_DELIMITER)
+            {
+                // Пустой кадр (два разделителя подряд) - продолжаем ждать данные
+                if (m_rx_len == 0) return true;
+
+                process_frame();
+                m_state = RX_TEXT;
+                return true;
+            }
+            if (m_rx_len == sizeof(m_rx_buf))
+            {
+                // Слишком длинный кадр или случайный 0x00 перед текстом
+                m_stats.overruns++;
+                m_state = RX_DISCARD;
+                return true;
+            }
+            m_rx_buf[m_rx_len++] = byte;
+            return true;
+
+        case RX_DISCARD:
+        default:
+            // Выходим из двоичного режима по разделителю или концу строки,
+            // чтобы CLI не терял команды после ошибочного 0x00
+            if (byte == FRAME_DELIMITER || byte == '\r')
+            {
+                m_state = RX_TEXT;
+                return byte == FRAME_DELIMITER;
+            }
+            return true;
+    }
+}
+
+void bin_proto_get_stats(bin_proto_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
+
+#else
+
+void bin_proto_init(bin_proto_write_t write) {}
+bool bin_proto_rx_byte(uint8_t byte) { return false; }
+bin_proto_status_t bin_proto_execute(uint8_t cmd, uint8_t const * p_data, uint32_t data_len,
+                                     uint8_t * p_reply, uint32_t * p_reply_len)
+{
+    *p_reply_len = 0;
+    return BIN_STATUS_UNKNOWN_CMD;
+}
+void bin_proto_get_stats(bin_proto_stats_t * p_stats) { memset(p_stats, 0, sizeof(*p_stats)); }
+
+#endif
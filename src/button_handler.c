@@ -1,84 +1,736 @@
 #include "button_handler.h"
-#include "app_logic.h"
+#include "event_queue.h"
 #include "nrfx_gpiote.h"
-#include "app_timer.h"
 #include "nrf_gpio.h"
+#include "nrf_delay.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+#include "perf.h"
+#include "trace.h"
+#include <string.h>
+
+#if !ESTC_BUTTON_LOW_POWER
+#include "nrfx_timer.h"
+#include "nrfx_ppi.h"
+#endif
+
+// Тайминги по умолчанию
+#define DEBOUNCE_MS         10      // Тишина на линии, после которой фронт считается установившимся
+#define CLICK_GAP_MS        300
+#define LONG_PRESS_MS       400
+#define REPEAT_MS           100
+
+// Наибольшее распознаваемое число кликов в серии
+#define MAX_CLICKS          3
+
+// Частота счетчика app_timer: RTC1 с делителем APP_TIMER_CONFIG_RTC_FREQUENCY + 1
+#define RTC_TICK_FREQ       (APP_TIMER_CLOCK_FREQ / (APP_TIMER_CONFIG_RTC_FREQUENCY + 1))
+// Погрешность задержки: метка события и момент выдачи округлены до шага RTC
+#define TIMESTAMP_SLACK_US  (2 * ((1000000UL + RTC_TICK_FREQ - 1) / RTC_TICK_FREQ))
+
+// Опрос матрицы
+#define MATRIX_SCAN_MS      5       // Период опроса, пока нажата хотя бы одна клавиша
+#define MATRIX_SETTLE_US    5       // Установление столбцов после выбора строки
+#define MATRIX_STABLE_SCANS 2       // Одинаковых опросов для смены состояния клавиши
+
+// Источник фронтов отдельных кнопок выбирается при сборке (ESTC_BUTTON_LOW_POWER):
+//
+// 0 - каналы GPIOTE IN (высокая точность) + PPI + TIMER3/TIMER2.
+//     TIMER3 - свободный счетчик меток времени (1 МГц), TIMER2 - общее окно антидребезга.
+//     Фронт кнопки через PPI перезапускает TIMER2, поэтому дребезг не вызывает прерываний;
+//     прерывание одно - по окончании окна. Метку в свой канал CC TIMER3 захватывает только
+//     первый фронт окна: канал PPI захвата отключает свою группу до конца окна.
+//     Точность метки 1 мкс, но в простое постоянно включены каналы IN и HFCLK
+//     (по datasheet: I_GPIOTE,IN порядка 20 мкА плюс ток HFINT для TIMER).
+//
+// 1 - событие GPIOTE PORT (SENSE, защелка DETECT) + app_timer на RTC1.
+//     Первый фронт вызывает прерывание, SENSE кнопки отключается на время окна
+//     антидребезга, после окна уровень читается и SENSE включается снова.
+//     Точность метки ~61 мкс (RTC), в простое добавка ~0.1 мкА (I_GPIOTE,PORT),
+//     HFCLK не требуется.
+//
+// Матрица в обоих режимах работает по событиям: в простое все строки притянуты
+// к нулю, столбцы ждут нажатия через SENSE. Опрос по таймеру идет, только пока
+// нажата хотя бы одна клавиша, затем матрица возвращается в режим ожидания.
+#if !ESTC_BUTTON_LOW_POWER
+// Каналы CC0..CC4 - метки фронтов отдельных кнопок
+#define TIMESTAMP_CC_NOW    NRF_TIMER_CC_CHANNEL5
+#endif
+
+// Состояния распознавателя жестов
+typedef enum
+{
+    GESTURE_IDLE,       // Кнопка отпущена, серии нет
+    GESTURE_DOWN,       // Нажата, ждем отпускания или порога удержания
+    GESTURE_UP_WAIT,    // Отпущена, ждем следующего клика серии
+    GESTURE_HOLD,       // Удержание
+    GESTURE_STATE_COUNT
+} gesture_state_t;
+
+// Входные воздействия
+typedef enum
+{
+    GESTURE_INPUT_PRESS,
+    GESTURE_INPUT_RELEASE,
+    GESTURE_INPUT_TIMEOUT
+} gesture_input_t;
+
+// Состояние одной кнопки
+typedef struct
+{
+    gesture_state_t state;
+    uint8_t         click_count;
+    bool            is_pressed;         // Установившийся уровень
+    uint32_t        edge_us;            // Метка последнего фронта
+#if ESTC_BUTTON_LOW_POWER
+    uint32_t        pending_edge_us;    // Метка первого фронта окна антидребезга
+#endif
+    uint32_t        timer_generation;   // Отсекает сработавший до остановки таймер
+} button_t;
+
+// Действие перехода, возвращает следующее состояние
+typedef gesture_state_t (*gesture_action_t)(uint8_t id, button_t * p_button, uint32_t timestamp_us);
+
+typedef struct
+{
+    gesture_state_t  state;
+    gesture_input_t  input;
+    gesture_action_t action;
+} gesture_transition_t;
+
+// Контекст таймера жеста: номер кнопки (старший байт) и поколение
+#define TIMER_CONTEXT(id, gen)      ((void *)(uintptr_t)(((uint32_t)(id) << 24) | ((gen) & 0xFFFFFF)))
+#define TIMER_CONTEXT_ID(ctx)       ((uint8_t)((uint32_t)(uintptr_t)(ctx) >> 24))
+#define TIMER_CONTEXT_GEN(ctx)      ((uint32_t)(uintptr_t)(ctx) & 0xFFFFFF)
+
+#if !ESTC_BUTTON_LOW_POWER
+static const nrfx_timer_t m_timestamp_timer = NRFX_TIMER_INSTANCE(3);
+static const nrfx_timer_t m_debounce_timer  = NRFX_TIMER_INSTANCE(2);
+
+// Группы PPI с каналом захвата метки каждой кнопки
+static nrf_ppi_channel_group_t m_capture_groups[BUTTON_MAX_PINS];
+#else
+static app_timer_t    m_debounce_timer_data[BUTTON_MAX_PINS];
+static app_timer_id_t m_debounce_timers[BUTTON_MAX_PINS];
+
+// Накопленное время RTC (тики RTC_TICK_FREQ = 16384 Гц)
+static uint32_t m_rtc_last;
+static uint64_t m_rtc_ticks_total;
+
+// Период накопления - четверть периода переполнения счетчика RTC1
+#define RTC_ACCUMULATE_TICKS    ((APP_TIMER_MAX_CNT_VAL + 1) / 4)
+
+APP_TIMER_DEF(m_rtc_accumulate_timer);
+#endif
+
+static app_timer_t    m_gesture_timer_data[BUTTON_MAX_COUNT];
+static app_timer_id_t m_gesture_timers[BUTTON_MAX_COUNT];
+
+APP_TIMER_DEF(m_matrix_scan_timer);
+
+static button_t m_buttons[BUTTON_MAX_COUNT];
+static uint8_t  m_button_count;
+
+// Отдельные кнопки
+static uint32_t m_pins[BUTTON_MAX_PINS];
+static uint8_t  m_pin_count;
+
+// Матрица
+static uint32_t m_row_pins[BUTTON_MAX_COUNT];
+static uint32_t m_col_pins[BUTTON_MAX_COUNT];
+static uint8_t  m_row_count;
+static uint8_t  m_col_count;
+static uint8_t  m_matrix_first_id;
+static uint8_t  m_matrix_stable_cnt[BUTTON_MAX_COUNT];
+static bool     m_matrix_scanning = false;
+
+static button_timing_t m_timing = {
+    .debounce_ms   = DEBOUNCE_MS,
+    .click_gap_ms  = CLICK_GAP_MS,
+    .long_press_ms = LONG_PRESS_MS,
+    .repeat_ms     = REPEAT_MS
+};
+
+static button_latency_t m_latency;
+
+static const char * const m_event_names[BUTTON_EVENT_COUNT] = {
+    "click", "double_click", "triple_click", "long_press", "hold_repeat", "released"
+};
+
+// Передача события в основной цикл с учетом задержки классификации
+static void post_button_event(uint8_t id, button_event_t event, uint32_t timestamp_us)
+{
+    uint32_t latency_us = button_handler_time_us() - timestamp_us;
+
+    m_latency.last_us[event] = latency_us;
+    m_latency.count[event]++;
+    if (latency_us > m_latency.max_us[event])
+    {
+        m_latency.max_us[event] = latency_us;
+    }
+
+    app_event_t app_event = {
+        .type         = APP_EVENT_BUTTON,
+        .arg          = event,
+        .id           = id,
+        .timestamp_us = timestamp_us
+    };
+    event_queue_put(&app_event);
+}
+
+// Взвод таймаута жеста относительно метки фронта
+static void gesture_timer_start(uint8_t id, button_t * p_button, uint32_t from_us, uint32_t timeout_ms)
+{
+    uint32_t elapsed_us = button_handler_time_us() - from_us;
+    uint32_t timeout_us = timeout_ms * 1000;
+    uint32_t remain_us  = (elapsed_us < timeout_us) ? (timeout_us - elapsed_us) : 0;
+
+    uint32_t ticks = (uint32_t)(((uint64_t)remain_us * RTC_TICK_FREQ) / 1000000);
+    if (ticks < APP_TIMER_MIN_TIMEOUT_TICKS) ticks = APP_TIMER_MIN_TIMEOUT_TICKS;
+
+    app_timer_stop(m_gesture_timers[id]);
+    p_button->timer_generation++;
+    app_timer_start(m_gesture_timers[id], ticks, TIMER_CONTEXT(id, p_button->timer_generation));
+}
+
+static void gesture_timer_stop(uint8_t id, button_t * p_button)
+{
+    app_timer_stop(m_gesture_timers[id]);
+    p_button->timer_generation++;
+}
+
+// Действия переходов
+
+static gesture_state_t on_first_press(uint8_t id, button_t * p_button, uint32_t timestamp_us)
+{
+    p_button->click_count = 1;
+    gesture_timer_start(id, p_button, timestamp_us, m_timing.long_press_ms);
+    return GESTURE_DOWN;
+}
+
+static gesture_state_t on_next_press(uint8_t id, button_t * p_button, uint32_t timestamp_us)
+{
+    p_button->click_count++;
+    gesture_timer_start(id, p_button, timestamp_us, m_timing.long_press_ms);
+    return GESTURE_DOWN;
+}
+
+static gesture_state_t on_short_release(uint8_t id, button_t * p_button, uint32_t timestamp_us)
+{
+    if (p_button->click_count >= MAX_CLICKS)
+    {
+        // Серия не может продолжиться -> выдаем сразу
+        gesture_timer_stop(id, p_button);
+        post_button_event(id, BUTTON_EVENT_TRIPLE_CLICK, timestamp_us);
+        return GESTURE_IDLE;
+    }
+    gesture_timer_start(id, p_button, timestamp_us, m_timing.click_gap_ms);
+    return GESTURE_UP_WAIT;
+}
+
+static gesture_state_t on_long_press(uint8_t id, button_t * p_button, uint32_t timestamp_us)
+{
+    post_button_event(id, BUTTON_EVENT_LONG_PRESS, p_button->edge_us);
+    gesture_timer_start(id, p_button, button_handler_time_us(), m_timing.repeat_ms);
+    return GESTURE_HOLD;
+}
+
+static gesture_state_t on_hold_repeat(uint8_t id, button_t * p_button, uint32_t timestamp_us)
+{
+    uint32_t now_us = button_handler_time_us();
+    post_button_event(id, BUTTON_EVENT_HOLD_REPEAT, now_us);
+    gesture_timer_start(id, p_button, now_us, m_timing.repeat_ms);
+    return GESTURE_HOLD;
+}
+
+static gesture_state_t on_hold_release(uint8_t id, button_t * p_button, uint32_t timestamp_us)
+{
+    gesture_timer_stop(id, p_button);
+    post_button_event(id, BUTTON_EVENT_RELEASED, timestamp_us);
+    return GESTURE_IDLE;
+}
+
+static gesture_state_t on_series_end(uint8_t id, button_t * p_button, uint32_t timestamp_us)
+{
+    static const button_event_t click_events[MAX_CLICKS] = {
+        BUTTON_EVENT_CLICK, BUTTON_EVENT_DOUBLE_CLICK, BUTTON_EVENT_TRIPLE_CLICK
+    };
+    post_button_event(id, click_events[p_button->click_count - 1], p_button->edge_us);
+    return GESTURE_IDLE;
+}
+
+// Таблица переходов; отсутствующие пары (состояние, вход) игнорируются
+static const gesture_transition_t m_transitions[] = {
+    { GESTURE_IDLE,    GESTURE_INPUT_PRESS,   on_first_press   },
+    { GESTURE_DOWN,    GESTURE_INPUT_RELEASE, on_short_release },
+    { GESTURE_DOWN,    GESTURE_INPUT_TIMEOUT, on_long_press    },
+    { GESTURE_UP_WAIT, GESTURE_INPUT_PRESS,   on_next_press    },
+    { GESTURE_UP_WAIT, GESTURE_INPUT_TIMEOUT, on_series_end    },
+    { GESTURE_HOLD,    GESTURE_INPUT_TIMEOUT, on_hold_repeat   },
+    { GESTURE_HOLD,    GESTURE_INPUT_RELEASE, on_hold_release  },
+};
+
+static void gesture_process(uint8_t id, gesture_input_t input, uint32_t timestamp_us)
+{
+    button_t * p_button = &m_buttons[id];
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(m_transitions); i++)
+    {
+        if (m_transitions[i].state == p_button->state && m_transitions[i].input == input)
+        {
+            p_button->state = m_transitions[i].action(id, p_button, timestamp_us);
+            return;
+        }
+    }
+}
+
+// Установившийся уровень кнопки
+static void button_level(uint8_t id, bool is_pressed, uint32_t edge_us)
+{
+    button_t * p_button = &m_buttons[id];
+
+    // Дребезг вернул линию в прежнее состояние
+    if (is_pressed == p_button->is_pressed) return;
+
+    p_button->is_pressed = is_pressed;
+    p_button->edge_us    = edge_us;
+
+    TRACE_AT(BTN_EDGE, edge_us, id, is_pressed);
+    TRACE(BTN_DEBOUNCE, id, is_pressed);
+
+    gesture_process(id, is_pressed ? GESTURE_INPUT_PRESS : GESTURE_INPUT_RELEASE, edge_us);
+}
+
+// Таймаут жеста
+static void gesture_timer_handler(void * p_context)
+{
+    uint8_t id = TIMER_CONTEXT_ID(p_context);
+
+    // Таймер был перезапущен после срабатывания
+    if (TIMER_CONTEXT_GEN(p_context) != (m_buttons[id].timer_generation & 0xFFFFFF)) return;
+
+    PERF_BEGIN(TMR_GESTURE);
+    gesture_process(id, GESTURE_INPUT_TIMEOUT, button_handler_time_us());
+    PERF_END(TMR_GESTURE);
+}
+
+#if !ESTC_BUTTON_LOW_POWER
+
+// Таймер меток работает без прерываний
+static void timestamp_timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+}
+
+// Окно антидребезга истекло: все линии установились
+static void debounce_timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    if (event_type != NRF_TIMER_EVENT_COMPARE0) return;
+
+    PERF_BEGIN(TMR_DEBOUNCE);
+    for (uint8_t id = 0; id < m_pin_count; id++)
+    {
+        // Время первого фронта кнопки в окне (или более раннего, если фронтов не было)
+        uint32_t edge_us = nrfx_timer_capture_get(&m_timestamp_timer, (nrf_timer_cc_channel_t)id);
+
+        // Захват снова разрешен до чтения: фронт после чтения получит свою метку
+        nrfx_ppi_group_enable(m_capture_groups[id]);
+
+        // Читаем состояние (0 = нажата)
+        bool is_pressed = !nrfx_gpiote_in_is_set(m_pins[id]);
+
+        button_level(id, is_pressed, edge_us);
+    }
+    PERF_END(TMR_DEBOUNCE);
+}
+
+// Длительность окна антидребезга
+static void debounce_window_set(uint16_t debounce_ms)
+{
+    nrfx_timer_extended_compare(&m_debounce_timer, NRF_TIMER_CC_CHANNEL0,
+                                nrfx_timer_us_to_ticks(&m_debounce_timer, debounce_ms * 1000UL),
+                                NRF_TIMER_SHORT_COMPARE0_STOP_MASK | NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK,
+                                true);
+}
+
+// Настройка таймеров меток и антидребезга
+static void timestamp_init(void)
+{
+    nrfx_timer_config_t timer_config = NRFX_TIMER_DEFAULT_CONFIG;
+    timer_config.frequency = NRF_TIMER_FREQ_1MHz;
+    timer_config.mode      = NRF_TIMER_MODE_TIMER;
+    timer_config.bit_width = NRF_TIMER_BIT_WIDTH_32;
+
+    nrfx_timer_init(&m_timestamp_timer, &timer_config, timestamp_timer_handler);
+    nrfx_timer_init(&m_debounce_timer, &timer_config, debounce_timer_handler);
+
+    // Одиночный отсчет окна: по совпадению - остановка, сброс и прерывание
+    debounce_window_set(m_timing.debounce_ms);
+
+    // Счетчик меток работает постоянно
+    nrfx_timer_enable(&m_timestamp_timer);
+}
+
+// Настройка канала IN и каналов PPI отдельной кнопки
+static void pin_source_init(uint8_t id)
+{
+    // Настройка на любой фронт (канал IN нужен для события PPI)
+    nrfx_gpiote_in_config_t in_config = NRFX_GPIOTE_CONFIG_IN_SENSE_TOGGLE(true);
+    in_config.pull = NRF_GPIO_PIN_PULLUP;
+
+    nrfx_gpiote_in_init(m_pins[id], &in_config, NULL);
+    m_buttons[id].is_pressed = !nrfx_gpiote_in_is_set(m_pins[id]);
 
-// Настройки таймингов
-#define DEBOUNCE_MS         50
-#define DOUBLE_CLICK_MS     400
+    uint32_t edge_event = nrfx_gpiote_in_event_addr_get(m_pins[id]);
+    nrf_ppi_channel_t ppi_capture;
+    nrf_ppi_channel_t ppi_start;
 
-APP_TIMER_DEF(m_debounce_timer);
-APP_TIMER_DEF(m_double_click_timer);
+    // Фронт -> захват метки в канал кнопки + отключение захвата до конца окна.
+    // Иначе метка бралась бы от последнего фронта дребезга, а не от первого
+    nrfx_ppi_group_alloc(&m_capture_groups[id]);
+    nrfx_ppi_channel_alloc(&ppi_capture);
+    nrfx_ppi_channel_assign(ppi_capture, edge_event,
+                            nrfx_timer_capture_task_address_get(&m_timestamp_timer, id));
+    nrfx_ppi_channel_fork_assign(ppi_capture, nrfx_ppi_task_addr_group_disable_get(m_capture_groups[id]));
+    nrfx_ppi_channel_include_in_group(ppi_capture, m_capture_groups[id]);
 
-static uint32_t m_button_pin;
-static bool     m_wait_for_double_click = false;
+    // Фронт -> сброс и запуск окна антидребезга
+    nrfx_ppi_channel_alloc(&ppi_start);
+    nrfx_ppi_channel_assign(ppi_start, edge_event,
+                            nrfx_timer_task_address_get(&m_debounce_timer, NRF_TIMER_TASK_CLEAR));
+    nrfx_ppi_channel_fork_assign(ppi_start,
+                                 nrfx_timer_task_address_get(&m_debounce_timer, NRF_TIMER_TASK_START));
 
-// Сброс флага двойного клика
-static void double_click_timer_handler(void * p_context)
+    nrfx_ppi_group_enable(m_capture_groups[id]);
+    nrfx_ppi_channel_enable(ppi_start);
+
+    // Событие без прерывания: фронты обрабатывает только PPI
+    nrfx_gpiote_in_event_enable(m_pins[id], false);
+}
+
+// Текущее время по таймеру меток. Канал TIMESTAMP_CC_NOW общий для основного
+// цикла и прерываний: захват и чтение не должны разделяться вытеснением
+uint32_t button_handler_time_us(void)
 {
-    m_wait_for_double_click = false;
+    uint32_t time_us;
+
+    CRITICAL_REGION_ENTER();
+    time_us = nrfx_timer_capture(&m_timestamp_timer, TIMESTAMP_CC_NOW);
+    CRITICAL_REGION_EXIT();
+
+    return time_us;
 }
 
-// Обработка нажатия после антидребезга
+#else
+
+// Окно антидребезга истекло: читаем уровень и снова включаем SENSE
 static void debounce_timer_handler(void * p_context)
 {
-    if (!nrfx_gpiote_is_init()) return;
+    uint8_t id = (uint8_t)(uintptr_t)p_context;
+
+    PERF_BEGIN(TMR_DEBOUNCE);
+
+    // SENSE настраивается драйвером по текущему уровню. Включаем до чтения:
+    // фронт после чтения вызовет новое окно, а не потеряется
+    nrfx_gpiote_in_event_enable(m_pins[id], true);
 
     // Читаем состояние (0 = нажата)
-    bool is_pressed = !nrfx_gpiote_in_is_set(m_button_pin);
+    bool is_pressed = !nrfx_gpiote_in_is_set(m_pins[id]);
 
-    if (is_pressed)
+    // Метка станет edge_us, только если уровень действительно изменился
+    button_level(id, is_pressed, m_buttons[id].pending_edge_us);
+
+    PERF_END(TMR_DEBOUNCE);
+}
+
+// Событие PORT: первый фронт серии дребезга
+static void button_port_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
+{
+    for (uint8_t id = 0; id < m_pin_count; id++)
     {
-        // Сообщаем логике о нажатии
-        app_logic_on_button_event(BUTTON_EVENT_PRESSED);
+        if (m_pins[id] != pin) continue;
+
+        // Метка первого фронта, остальные фронты окна не вызывают прерываний.
+        // Дребезг может вернуть прежний уровень: edge_us (по нему считаются
+        // удержание и серия кликов) обновит только button_level()
+        m_buttons[id].pending_edge_us = button_handler_time_us();
+        nrfx_gpiote_in_event_disable(pin);
+
+        app_timer_start(m_debounce_timers[id], APP_TIMER_TICKS(m_timing.debounce_ms),
+                        (void *)(uintptr_t)id);
+        return;
+    }
+}
+
+// Длительность окна задается при каждом запуске таймера
+static void debounce_window_set(uint16_t debounce_ms)
+{
+}
+
+// Время накапливается при каждом чтении. Без чтений дольше периода
+// переполнения счетчика (1024 с) обороты терялись бы, поэтому таймер
+// читает время сам, раз в четверть периода
+static void rtc_accumulate_handler(void * p_context)
+{
+    (void)button_handler_time_us();
+}
+
+static void timestamp_init(void)
+{
+    app_timer_create(&m_rtc_accumulate_timer, APP_TIMER_MODE_REPEATED, rtc_accumulate_handler);
+    app_timer_start(m_rtc_accumulate_timer, RTC_ACCUMULATE_TICKS, NULL);
+}
+
+// Настройка SENSE и таймера антидребезга отдельной кнопки
+static void pin_source_init(uint8_t id)
+{
+    // Низкая точность: PORT событие вместо канала IN
+    nrfx_gpiote_in_config_t in_config = NRFX_GPIOTE_CONFIG_IN_SENSE_TOGGLE(false);
+    in_config.pull = NRF_GPIO_PIN_PULLUP;
+
+    nrfx_gpiote_in_init(m_pins[id], &in_config, button_port_handler);
+    m_buttons[id].is_pressed = !nrfx_gpiote_in_is_set(m_pins[id]);
+
+    m_debounce_timers[id] = &m_debounce_timer_data[id];
+    app_timer_create(&m_debounce_timers[id], APP_TIMER_MODE_SINGLE_SHOT, debounce_timer_handler);
 
-        if (m_wait_for_double_click)
+    nrfx_gpiote_in_event_enable(m_pins[id], true);
+}
+
+// Текущее время по RTC1. Счетчик 24-битный (1024 с при 16384 Гц), обороты
+// между чтениями не теряются благодаря rtc_accumulate_handler().
+uint32_t button_handler_time_us(void)
+{
+    uint32_t time_us;
+
+    CRITICAL_REGION_ENTER();
+    uint32_t now = app_timer_cnt_get();
+    m_rtc_ticks_total += app_timer_cnt_diff_compute(now, m_rtc_last);
+    m_rtc_last = now;
+    time_us = (uint32_t)((m_rtc_ticks_total * 1000000) / RTC_TICK_FREQ);
+    CRITICAL_REGION_EXIT();
+
+    return time_us;
+}
+
+#endif
+
+// Матрица в ожидании: все строки в нуле, нажатие любой клавиши опускает свой столбец
+static void matrix_rows_idle(void)
+{
+    for (uint8_t r = 0; r < m_row_count; r++)
+    {
+        nrf_gpio_pin_clear(m_row_pins[r]);
+        nrf_gpio_cfg_output(m_row_pins[r]);
+    }
+}
+
+static void matrix_sense_enable(bool enable)
+{
+    for (uint8_t c = 0; c < m_col_count; c++)
+    {
+        if (enable)
         {
-            // Второе нажатие -> двойной клик
-            app_logic_on_button_event(BUTTON_EVENT_DOUBLE_CLICK);
-            
-            m_wait_for_double_click = false;
-            app_timer_stop(m_double_click_timer);
+            nrfx_gpiote_in_event_enable(m_col_pins[c], true);
         }
         else
         {
-            // Первое нажатие -> ждем второе
-            m_wait_for_double_click = true;
-            app_timer_start(m_double_click_timer, APP_TIMER_TICKS(DOUBLE_CLICK_MS), NULL);
+            nrfx_gpiote_in_event_disable(m_col_pins[c]);
+        }
+    }
+}
+
+// Опрос матрицы: в ноль притянута одна строка, остальные отключены
+static void matrix_scan_timer_handler(void * p_context)
+{
+    PERF_BEGIN(TMR_MATRIX_SCAN);
+
+    uint32_t now_us = button_handler_time_us();
+    bool any_pressed = false;
+
+    for (uint8_t r = 0; r < m_row_count; r++)
+    {
+        nrf_gpio_cfg_default(m_row_pins[r]);
+    }
+
+    for (uint8_t r = 0; r < m_row_count; r++)
+    {
+        nrf_gpio_cfg_output(m_row_pins[r]);
+        nrf_delay_us(MATRIX_SETTLE_US);
+
+        for (uint8_t c = 0; c < m_col_count; c++)
+        {
+            uint8_t key = r * m_col_count + c;
+            uint8_t id  = m_matrix_first_id + key;
+            bool is_down = !nrf_gpio_pin_read(m_col_pins[c]);
+
+            // Антидребезг: смена состояния после нескольких одинаковых опросов
+            if (is_down == m_buttons[id].is_pressed)
+            {
+                m_matrix_stable_cnt[key] = 0;
+            }
+            else if (++m_matrix_stable_cnt[key] >= MATRIX_STABLE_SCANS)
+            {
+                m_matrix_stable_cnt[key] = 0;
+                button_level(id, is_down, now_us);
+            }
+
+            any_pressed |= is_down || m_buttons[id].is_pressed;
         }
+
+        nrf_gpio_cfg_default(m_row_pins[r]);
+    }
+
+    matrix_rows_idle();
+
+    // Все отпущено -> останавливаем опрос и ждем следующего нажатия
+    if (!any_pressed)
+    {
+        app_timer_stop(m_matrix_scan_timer);
+        m_matrix_scanning = false;
+        matrix_sense_enable(true);
+    }
+
+    PERF_END(TMR_MATRIX_SCAN);
+}
+
+// Нажатие в режиме ожидания: переходим к опросу
+static void matrix_sense_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
+{
+    if (m_matrix_scanning) return;
+
+    m_matrix_scanning = true;
+    matrix_sense_enable(false);
+    app_timer_start(m_matrix_scan_timer, APP_TIMER_TICKS(MATRIX_SCAN_MS), NULL);
+}
+
+static void matrix_init(void)
+{
+    m_matrix_first_id = m_pin_count;
+
+    // Строки в режиме ожидания заранее в нуле (выходной регистр)
+    matrix_rows_idle();
+
+    for (uint8_t c = 0; c < m_col_count; c++)
+    {
+        nrfx_gpiote_in_config_t in_config = NRFX_GPIOTE_CONFIG_IN_SENSE_HITOLO(false);
+        in_config.pull = NRF_GPIO_PIN_PULLUP;
+        nrfx_gpiote_in_init(m_col_pins[c], &in_config, matrix_sense_handler);
     }
-    else
+
+    app_timer_create(&m_matrix_scan_timer, APP_TIMER_MODE_REPEATED, matrix_scan_timer_handler);
+
+    matrix_sense_enable(true);
+}
+
+bool button_handler_set_timing(button_timing_t const * p_timing)
+{
+    if (p_timing->debounce_ms   < 1   || p_timing->debounce_ms   > 50   ||
+        p_timing->click_gap_ms  < 50  || p_timing->click_gap_ms  > 2000 ||
+        p_timing->long_press_ms < 100 || p_timing->long_press_ms > 5000 ||
+        p_timing->repeat_ms     < 20  || p_timing->repeat_ms     > 2000)
     {
-        // Сообщаем логике об отпускании
-        app_logic_on_button_event(BUTTON_EVENT_RELEASED);
+        return false;
     }
+
+    m_timing = *p_timing;
+    debounce_window_set(m_timing.debounce_ms);
+    return true;
 }
 
-// Обработчик прерывания GPIO
-static void button_gpiote_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
+void button_handler_get_timing(button_timing_t * p_timing)
 {
-    // Запускаем таймер антидребезга
-    app_timer_start(m_debounce_timer, APP_TIMER_TICKS(DEBOUNCE_MS), NULL);
+    *p_timing = m_timing;
 }
 
-// Инициализация кнопки
-void button_handler_init(uint32_t button_pin)
+uint32_t button_handler_latency_bound_us(button_event_t event)
 {
-    m_button_pin = button_pin;
+    // Плюс окно антидребезга (для матрицы - опросы) и шаг RTC.
+    // При ESTC_BUTTON_LOW_POWER=0 метка - первый фронт, а окно перезапускает
+    // каждый фронт: сверх границы добавляется длительность дребезга
+    uint32_t settle_ms = m_timing.debounce_ms;
+    if (m_row_count * m_col_count > 0)
+    {
+        settle_ms = MAX(settle_ms, MATRIX_SCAN_MS * (MATRIX_STABLE_SCANS + 1));
+    }
+    uint32_t slack_us = settle_ms * 1000UL + TIMESTAMP_SLACK_US;
+
+    switch (event)
+    {
+        case BUTTON_EVENT_CLICK:
+        case BUTTON_EVENT_DOUBLE_CLICK:
+            // От последнего отпускания: пауза серии
+            return m_timing.click_gap_ms * 1000UL + slack_us;
+        case BUTTON_EVENT_LONG_PRESS:
+            // От нажатия: порог удержания
+            return m_timing.long_press_ms * 1000UL + slack_us;
+        case BUTTON_EVENT_TRIPLE_CLICK:
+        case BUTTON_EVENT_RELEASED:
+            // Выдаются по фронту
+            return slack_us;
+        case BUTTON_EVENT_HOLD_REPEAT:
+        default:
+            // Метка - момент выдачи по таймеру повтора
+            return TIMESTAMP_SLACK_US;
+    }
+}
+
+void button_handler_get_latency(button_latency_t * p_latency, bool reset)
+{
+    *p_latency = m_latency;
+    if (reset)
+    {
+        memset(&m_latency, 0, sizeof(m_latency));
+    }
+}
+
+const char * button_handler_event_name(button_event_t event)
+{
+    return (event < BUTTON_EVENT_COUNT) ? m_event_names[event] : "unknown";
+}
+
+uint8_t button_handler_count(void)
+{
+    return m_button_count;
+}
+
+// Инициализация кнопок
+void button_handler_init(button_config_t const * p_config)
+{
+    m_pin_count = MIN(p_config->pin_count, BUTTON_MAX_PINS);
+    memcpy(m_pins, p_config->p_pins, m_pin_count * sizeof(uint32_t));
+
+    // Матрица получает идентификаторы после отдельных кнопок
+    m_row_count = p_config->row_count;
+    m_col_count = p_config->col_count;
+    if (m_pin_count + m_row_count * m_col_count > BUTTON_MAX_COUNT)
+    {
+        m_row_count = 0;
+        m_col_count = 0;
+    }
+    memcpy(m_row_pins, p_config->p_row_pins, m_row_count * sizeof(uint32_t));
+    memcpy(m_col_pins, p_config->p_col_pins, m_col_count * sizeof(uint32_t));
+
+    m_button_count = m_pin_count + m_row_count * m_col_count;
 
     if (!nrfx_gpiote_is_init()) {
         nrfx_gpiote_init();
     }
 
-    // Настройка на любой фронт
-    nrfx_gpiote_in_config_t in_config = NRFX_GPIOTE_CONFIG_IN_SENSE_TOGGLE(true);
-    in_config.pull = NRF_GPIO_PIN_PULLUP;
-    
-    nrfx_gpiote_in_init(m_button_pin, &in_config, button_gpiote_handler);
-    nrfx_gpiote_in_event_enable(m_button_pin, true);
-
-    // Создаем таймеры
-    app_timer_create(&m_debounce_timer, APP_TIMER_MODE_SINGLE_SHOT, debounce_timer_handler);
-    app_timer_create(&m_double_click_timer, APP_TIMER_MODE_SINGLE_SHOT, double_click_timer_handler);
-}
\ No newline at end of file
+    for (uint8_t id = 0; id < m_button_count; id++)
+    {
+        m_gesture_timers[id] = &m_gesture_timer_data[id];
+        app_timer_create(&m_gesture_timers[id], APP_TIMER_MODE_SINGLE_SHOT, gesture_timer_handler);
+    }
+
+    timestamp_init();
+
+    for (uint8_t id = 0; id < m_pin_count; id++)
+    {
+        pin_source_init(id);
+    }
+
+    if (m_row_count * m_col_count > 0)
+    {
+        matrix_init();
+    }
+}
@@ -0,0 +1,197 @@
+#include "cli_compact.h"
+#include "nrf_fprintf.h"
+#include "perf.h"
+#include "cli_phash.h"
+#include <string.h>
+#include <stdarg.h>
+
+// Сгенерированный cli_phash.h: CLI_PHASH_SEED, CLI_PHASH_BITS, CLI_PHASH_COUNT
+// и m_cli_phash_slots[] - номер команды + 1 для каждой ячейки, 0 - пусто
+
+#define FNV_PRIME           16777619u
+// Символов за одно чтение из транспорта
+#define RX_CHUNK_SIZE       16
+// Буфер форматирования - один пакет USB
+#define PRINTF_BUFF_SIZE    64
+
+static nrf_cli_transport_t const * m_p_transport;
+static const char *                m_p_prompt;
+static cli_compact_cmd_t const *   m_p_cmds;
+
+static bool   m_echo = true;
+static char   m_line[NRF_CLI_CMD_BUFF_SIZE];
+static size_t m_line_len;
+static char   m_last_nl;
+
+// Обработчикам передается только как аргумент nrf_cli_fprintf()
+static const nrf_cli_t m_cli;
+
+static void transport_write(void const * p_data, size_t length)
+{
+    char const * p_str = p_data;
+
+    // Как nrf_cli без блокирующего режима: ждем освобождения передатчика
+    while (length != 0)
+    {
+        size_t cnt = 0;
+        if (m_p_transport->p_api->write(m_p_transport, p_str, length, &cnt) != NRF_SUCCESS) return;
+        p_str  += cnt;
+        length -= cnt;
+    }
+}
+
+static void fprintf_write(void const * p_user_ctx, char const * p_str, size_t length)
+{
+    transport_write(p_str, length);
+}
+
+static char m_printf_buff[PRINTF_BUFF_SIZE];
+NRF_FPRINTF_DEF(m_fprintf_ctx, NULL, m_printf_buff, PRINTF_BUFF_SIZE, true, fprintf_write);
+
+// Вывод обработчиков команд вместо nrf_cli; цвет не используется
+void nrf_cli_fprintf(nrf_cli_t const * p_cli, nrf_cli_vt100_color_t color, char const * p_fmt, ...)
+{
+    va_list args;
+    va_start(args, p_fmt);
+    nrf_fprintf_fmt(&m_fprintf_ctx, p_fmt, &args);
+    va_end(args);
+}
+
+// Номер команды по совершенному хешу или -1
+static int cmd_find(const char * p_name)
+{
+    PERF_BEGIN(CLI_LOOKUP);
+
+    // FNV-1a, старшие биты - номер ячейки (как в scripts/cli_phash.py)
+    uint32_t hash = CLI_PHASH_SEED;
+    for (const char * p = p_name; *p != '\0'; p++)
+    {
+        hash ^= (uint8_t)*p;
+        hash *= FNV_PRIME;
+    }
+
+    int index = (int)m_cli_phash_slots[hash >> (32 - CLI_PHASH_BITS)] - 1;
+
+    // Хеш совершенный только для известных имен: остальные сверяются по строке
+    if ((index >= 0) && (strcmp(m_p_cmds[index].p_name, p_name) != 0))
+    {
+        index = -1;
+    }
+
+    PERF_END(CLI_LOOKUP);
+    return index;
+}
+
+static void line_execute(void)
+{
+    char * argv[NRF_CLI_ARGC_MAX];
+    size_t argc = 0;
+    char * p = m_line;
+
+    m_line[m_line_len] = '\0';
+    m_line_len = 0;
+
+    // Разбиение на аргументы по пробелам прямо в буфере строки
+    while (*p != '\0')
+    {
+        if (*p == ' ')
+        {
+            *p++ = '\0';
+            continue;
+        }
+        if (argc == NRF_CLI_ARGC_MAX)
+        {
+            nrf_cli_fprintf(&m_cli, NRF_CLI_ERROR, "Too many arguments\n");
+            return;
+        }
+        argv[argc++] = p;
+        while (*p != '\0' && *p != ' ') p++;
+    }
+    if (argc == 0) return;
+
+    int index = cmd_find(argv[0]);
+    if (index < 0)
+    {
+        nrf_cli_fprintf(&m_cli, NRF_CLI_ERROR, "%s: command not found\n", argv[0]);
+        return;
+    }
+
+    m_p_cmds[index].handler(&m_cli, argc, argv);
+}
+
+static void char_process(char c)
+{
+    if ((c == '\r') || (c == '\n'))
+    {
+        // Как process_nl() в nrf_cli: строку завершает '\r' или '\n',
+        // второй символ пары CRLF/LFCR пропускается
+        if ((m_last_nl != 0) && (c != m_last_nl)) return;
+        m_last_nl = c;
+
+        if (m_echo) transport_write("\r\n", 2);
+        line_execute();
+        transport_write(m_p_prompt, strlen(m_p_prompt));
+        return;
+    }
+    m_last_nl = 0;
+
+    switch (c)
+    {
+
+        case '\b':
+        case 0x7F:
+            if (m_line_len != 0)
+            {
+                m_line_len--;
+                if (m_echo) transport_write("\b \b", 3);
+            }
+            break;
+
+        default:
+            // Управляющие последовательности и символы сверх буфера отбрасываются
+            if ((c >= ' ') && (c < 0x7F) && (m_line_len < sizeof(m_line) - 1))
+            {
+                m_line[m_line_len++] = c;
+                if (m_echo) transport_write(&c, 1);
+            }
+            break;
+    }
+}
+
+ret_code_t cli_compact_init(nrf_cli_transport_t const * p_transport, const char * p_prompt,
+                            cli_compact_cmd_t const * p_cmds, size_t count)
+{
+    // Таблица хеша построена для другого списка команд
+    if (count != CLI_PHASH_COUNT) return NRF_ERROR_INVALID_LENGTH;
+
+    m_p_transport = p_transport;
+    m_p_prompt    = p_prompt;
+    m_p_cmds      = p_cmds;
+
+    // События транспорта не нужны: прием опрашивается в основном цикле
+    ret_code_t ret = p_transport->p_api->init(p_transport, NULL, NULL, NULL);
+    if (ret != NRF_SUCCESS) return ret;
+
+    return p_transport->p_api->enable(p_transport, false);
+}
+
+void cli_compact_process(void)
+{
+    char   chunk[RX_CHUNK_SIZE];
+    size_t cnt;
+
+    do
+    {
+        cnt = 0;
+        m_p_transport->p_api->read(m_p_transport, chunk, sizeof(chunk), &cnt);
+        for (size_t i = 0; i < cnt; i++)
+        {
+            char_process(chunk[i]);
+        }
+    } while (cnt != 0);
+}
+
+void cli_compact_echo_set(bool on)
+{
+    m_echo = on;
+}
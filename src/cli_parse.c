@@ -0,0 +1,91 @@
+#include "cli_parse.h"
+#include <stddef.h>
+
+#define COLOR_DIGITS    6
+
+static const char * const m_status_names[] = {
+    "ok", "empty value", "invalid character", "number too large", "out of range", "expected #RRGGBB"
+};
+
+static cli_parse_result_t result(cli_parse_status_t status, size_t offset)
+{
+    cli_parse_result_t res = { status, (uint8_t)((offset > UINT8_MAX) ? UINT8_MAX : offset) };
+    return res;
+}
+
+// Значение шестнадцатеричной цифры или -1
+static int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+cli_parse_result_t cli_parse_uint(const char * p_str, uint32_t min, uint32_t max, uint32_t * p_value)
+{
+    size_t   i     = 0;
+    uint32_t base  = 10;
+    uint32_t value = 0;
+
+    if (p_str == NULL || p_str[0] == '\0') return result(CLI_PARSE_EMPTY, 0);
+
+    if (p_str[0] == '0' && (p_str[1] == 'x' || p_str[1] == 'X'))
+    {
+        base = 16;
+        i = 2;
+        if (p_str[i] == '\0') return result(CLI_PARSE_EMPTY, i);
+    }
+
+    for (; p_str[i] != '\0'; i++)
+    {
+        int digit = (base == 16) ? hex_digit(p_str[i]) :
+                    ((p_str[i] >= '0' && p_str[i] <= '9') ? p_str[i] - '0' : -1);
+        if (digit < 0) return result(CLI_PARSE_INVALID_CHAR, i);
+
+        // value * base + digit > UINT32_MAX
+        if (value > (UINT32_MAX - (uint32_t)digit) / base) return result(CLI_PARSE_OVERFLOW, i);
+        value = value * base + (uint32_t)digit;
+    }
+
+    if (value < min || value > max) return result(CLI_PARSE_OUT_OF_RANGE, 0);
+
+    *p_value = value;
+    return result(CLI_PARSE_OK, 0);
+}
+
+cli_parse_result_t cli_parse_color(const char * p_str, uint8_t * p_r, uint8_t * p_g, uint8_t * p_b)
+{
+    uint8_t rgb[COLOR_DIGITS / 2];
+
+    if (p_str == NULL || p_str[0] != '#') return result(CLI_PARSE_BAD_LENGTH, 0);
+
+    for (size_t i = 0; i < COLOR_DIGITS; i++)
+    {
+        char c = p_str[1 + i];
+        if (c == '\0') return result((i == 0) ? CLI_PARSE_EMPTY : CLI_PARSE_BAD_LENGTH, 1 + i);
+
+        int digit = hex_digit(c);
+        if (digit < 0) return result(CLI_PARSE_INVALID_CHAR, 1 + i);
+
+        if ((i & 1) == 0)
+        {
+            rgb[i / 2] = (uint8_t)(digit << 4);
+        }
+        else
+        {
+            rgb[i / 2] |= (uint8_t)digit;
+        }
+    }
+    if (p_str[1 + COLOR_DIGITS] != '\0') return result(CLI_PARSE_BAD_LENGTH, 1 + COLOR_DIGITS);
+
+    *p_r = rgb[0];
+    *p_g = rgb[1];
+    *p_b = rgb[2];
+    return result(CLI_PARSE_OK, 0);
+}
+
+const char * cli_parse_status_str(cli_parse_status_t status)
+{
+    return (status <= CLI_PARSE_BAD_LENGTH) ? m_status_names[status] : "unknown";
+}
@@ -0,0 +1,230 @@
+#include "color_stream.h"
+#include "pwm_handler.h"
+#include "nrfx_timer.h"
+#include <string.h>
+
+#define FRAME_DELIMITER     0xFF
+#define FRAME_LEN           3
+#define VALUE_MAX           254
+#define PWM_MAX             1000
+
+#define BUF_MASK            (STREAM_BUF_SIZE - 1)
+
+typedef struct
+{
+    int16_t r;
+    int16_t g;
+    int16_t b;
+} stream_color_t;
+
+static const nrfx_timer_t m_latch_timer = NRFX_TIMER_INSTANCE(4);
+static bool m_timer_ready = false;
+
+// Кольцевой буфер: head пишет основной цикл, tail - прерывание таймера
+static stream_color_t    m_buf[STREAM_BUF_SIZE];
+static volatile uint32_t m_head;
+static volatile uint32_t m_tail;
+
+static volatile bool m_active = false;
+static bool          m_playing;         // Буфер набран, идет вывод
+static uint32_t      m_depth;
+static uint32_t      m_missed;          // Выводов подряд без новых кадров
+
+static stream_color_t m_last;
+static stream_color_t m_prev;
+
+static uint8_t  m_rx_frame[FRAME_LEN];
+static uint32_t m_rx_len;
+static bool     m_rx_synced;            // Принят первый верный кадр
+
+static color_stream_stats_t m_stats;
+
+static int16_t clamp_pwm(int32_t value)
+{
+    if (value < 0) return 0;
+    if (value > PWM_MAX) return PWM_MAX;
+    return (int16_t)value;
+}
+
+// Вывод очередного кадра с частотой потока
+static void latch_timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    if (event_type != NRF_TIMER_EVENT_COMPARE0) return;
+
+    uint32_t count = m_head - m_tail;
+
+    if (!m_playing)
+    {
+        // Набираем буфер перед началом вывода
+        if (count < m_depth) return;
+        m_playing = true;
+    }
+
+    if (count > 2 * m_depth)
+    {
+        // Хост опережает вывод: отбрасываем старые кадры
+        m_stats.skipped += count - m_depth;
+        m_tail += count - m_depth;
+        count = m_depth;
+    }
+
+    if (count != 0)
+    {
+        m_prev = m_last;
+        m_last = m_buf[m_tail & BUF_MASK];
+        m_tail++;
+        m_missed = 0;
+        m_stats.latched++;
+    }
+    else
+    {
+        m_stats.underruns++;
+        m_missed++;
+
+        if (m_missed <= STREAM_EXTRAPOLATE_MAX)
+        {
+            // Продолжаем движение цвета с вдвое меньшим шагом
+            stream_color_t next;
+            next.r = clamp_pwm(m_last.r + (m_last.r - m_prev.r) / 2);
+            next.g = clamp_pwm(m_last.g + (m_last.g - m_prev.g) / 2);
+            next.b = clamp_pwm(m_last.b + (m_last.b - m_prev.b) / 2);
+            m_prev = m_last;
+            m_last = next;
+        }
+        if (m_missed >= STREAM_BUF_SIZE)
+        {
+            // Поток прервался: перед продолжением снова набираем буфер
+            m_playing = false;
+        }
+    }
+
+    pwm_handler_set_rgb(m_last.r, m_last.g, m_last.b);
+}
+
+static void frame_put(void)
+{
+    stream_color_t color;
+    color.r = m_rx_frame[0] * PWM_MAX / VALUE_MAX;
+    color.g = m_rx_frame[1] * PWM_MAX / VALUE_MAX;
+    color.b = m_rx_frame[2] * PWM_MAX / VALUE_MAX;
+
+    m_stats.received++;
+    if (m_head - m_tail >= STREAM_BUF_SIZE)
+    {
+        m_stats.overruns++;
+        return;
+    }
+
+    m_buf[m_head & BUF_MASK] = color;
+    // Кадр записан до сдвига head
+    __DMB();
+    m_head++;
+}
+
+bool color_stream_start(uint32_t rate_hz, uint32_t depth)
+{
+    if (rate_hz < STREAM_RATE_MIN_HZ || rate_hz > STREAM_RATE_MAX_HZ ||
+        depth == 0 || 2 * depth > STREAM_BUF_SIZE)
+    {
+        return false;
+    }
+
+    if (!m_timer_ready)
+    {
+        nrfx_timer_config_t timer_config = NRFX_TIMER_DEFAULT_CONFIG;
+        timer_config.frequency = NRF_TIMER_FREQ_1MHz;
+        timer_config.mode      = NRF_TIMER_MODE_TIMER;
+        timer_config.bit_width = NRF_TIMER_BIT_WIDTH_32;
+
+        nrfx_timer_init(&m_latch_timer, &timer_config, latch_timer_handler);
+        m_timer_ready = true;
+    }
+
+    m_head    = 0;
+    m_tail    = 0;
+    m_depth   = depth;
+    m_playing = false;
+    m_missed  = 0;
+    m_rx_len  = 0;
+    m_rx_synced = false;
+    memset(&m_last, 0, sizeof(m_last));
+    m_prev = m_last;
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    // Период вывода отсчитывается аппаратно: по совпадению - сброс и прерывание
+    nrfx_timer_extended_compare(&m_latch_timer, NRF_TIMER_CC_CHANNEL0,
+                                nrfx_timer_us_to_ticks(&m_latch_timer, 1000000UL / rate_hz),
+                                NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK,
+                                true);
+    nrfx_timer_clear(&m_latch_timer);
+    nrfx_timer_enable(&m_latch_timer);
+
+    m_active = true;
+    return true;
+}
+
+void color_stream_stop(uint16_t * p_r, uint16_t * p_g, uint16_t * p_b)
+{
+    // Остановленный TIMER4 не держит HFCLK
+    nrfx_timer_disable(&m_latch_timer);
+    m_active = false;
+
+    *p_r = m_last.r;
+    *p_g = m_last.g;
+    *p_b = m_last.b;
+}
+
+bool color_stream_is_active(void)
+{
+    return m_active;
+}
+
+bool color_stream_rx(uint8_t const * p_data, size_t length, size_t * p_used)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t byte = p_data[i];
+
+        // Остаток конца строки команды stream (CRLF) - не начало кадра
+        if (!m_rx_synced && (m_rx_len == 0) && ((byte == '\r') || (byte == '\n'))) continue;
+
+        if (byte != FRAME_DELIMITER)
+        {
+            if (m_rx_len < FRAME_LEN)
+            {
+                m_rx_frame[m_rx_len] = byte;
+            }
+            m_rx_len++;
+            continue;
+        }
+
+        uint32_t frame_len = m_rx_len;
+        m_rx_len = 0;
+
+        if (frame_len == 0)
+        {
+            // До первого кадра 0xFF не завершает поток
+            if (!m_rx_synced) continue;
+
+            // FF FF - конец потока, остаток данных снова принадлежит CLI
+            *p_used = i + 1;
+            return false;
+        }
+        if (frame_len != FRAME_LEN)
+        {
+            m_stats.bad_frames++;
+            continue;
+        }
+
+        m_rx_synced = true;
+        frame_put();
+    }
+
+    *p_used = length;
+    return true;
+}
+
+void color_stream_get_stats(color_stream_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
@@ -0,0 +1,32 @@
+#include "event_queue.h"
+#include "nrf_atfifo.h"
+
+// Неблокирующая очередь: пишут прерывания, читает основной цикл
+NRF_ATFIFO_DEF(m_event_fifo, app_event_t, EVENT_QUEUE_SIZE);
+
+static volatile uint32_t m_dropped = 0;
+
+void event_queue_init(void)
+{
+    NRF_ATFIFO_INIT(m_event_fifo);
+}
+
+bool event_queue_put(app_event_t const * p_event)
+{
+    if (nrf_atfifo_alloc_put(m_event_fifo, p_event, sizeof(app_event_t), NULL) != NRF_SUCCESS)
+    {
+        m_dropped++;
+        return false;
+    }
+    return true;
+}
+
+bool event_queue_get(app_event_t * p_event)
+{
+    return nrf_atfifo_get_free(m_event_fifo, p_event, sizeof(app_event_t), NULL) == NRF_SUCCESS;
+}
+
+uint32_t event_queue_dropped_count(void)
+{
+    return m_dropped;
+}
@@ -0,0 +1,97 @@
+#include "mem_monitor.h"
+#include "nrf.h"
+#include <errno.h>
+#include <malloc.h>
+#include <stddef.h>
+
+// Шаблон окраски стека
+#define STACK_PAINT_PATTERN     0xDEADBEEF
+// Запас под текущим указателем стека, который не окрашивается
+#define STACK_PAINT_MARGIN      64
+
+// Символы компоновщика (nrf_common.ld, blinky_gcc_nrf52.ld)
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+extern uint32_t __bss_start__;
+extern uint32_t __bss_end__;
+extern uint32_t __start_noinit;
+extern uint32_t __stop_noinit;
+extern uint32_t __HeapBase;
+extern uint32_t __HeapLimit;
+extern uint32_t __StackLimit;
+extern uint32_t __StackTop;
+
+static uint32_t m_heap_peak = 0;
+
+void mem_monitor_init(void)
+{
+    uint32_t * p_word = &__StackLimit;
+    uint32_t * p_end  = (uint32_t *)(__get_MSP() - STACK_PAINT_MARGIN);
+
+    while (p_word < p_end)
+    {
+        *p_word++ = STACK_PAINT_PATTERN;
+    }
+}
+
+// Замена _sbrk из libnosys: не выходит за __HeapLimit и запоминает максимум
+void * _sbrk(ptrdiff_t incr)
+{
+    static uint8_t * p_brk = (uint8_t *)&__HeapBase;
+
+    uint8_t * p_prev = p_brk;
+    uint8_t * p_next = p_brk + incr;
+
+    if (p_next > (uint8_t *)&__HeapLimit || p_next < (uint8_t *)&__HeapBase)
+    {
+        errno = ENOMEM;
+        return (void *)-1;
+    }
+
+    p_brk = p_next;
+
+    uint32_t used = p_brk - (uint8_t *)&__HeapBase;
+    if (used > m_heap_peak)
+    {
+        m_heap_peak = used;
+    }
+
+    return p_prev;
+}
+
+void mem_monitor_get(mem_usage_t * p_usage)
+{
+    // Первое слово, затертое стеком, - граница максимальной глубины
+    uint32_t const * p_word = &__StackLimit;
+    while (p_word < &__StackTop && *p_word == STACK_PAINT_PATTERN)
+    {
+        p_word++;
+    }
+
+    p_usage->stack_size    = (uint32_t)&__StackTop - (uint32_t)&__StackLimit;
+    p_usage->stack_peak    = (uint32_t)&__StackTop - (uint32_t)p_word;
+    p_usage->stack_current = (uint32_t)&__StackTop - __get_MSP();
+
+    p_usage->heap_size   = (uint32_t)&__HeapLimit - (uint32_t)&__HeapBase;
+    p_usage->heap_peak   = m_heap_peak;
+    p_usage->heap_in_use = (m_heap_peak != 0) ? mallinfo().uordblks : 0;
+}
+
+uint32_t mem_monitor_sections(mem_section_t * p_sections, uint32_t max_count)
+{
+    const mem_section_t sections[] = {
+        { "data",     (uint32_t)&__data_start__, (uint32_t)&__data_end__ - (uint32_t)&__data_start__ },
+        { "sdk_vars", (uint32_t)&__data_end__,   (uint32_t)&__bss_start__ - (uint32_t)&__data_end__ },
+        { "bss",      (uint32_t)&__bss_start__,  (uint32_t)&__bss_end__ - (uint32_t)&__bss_start__ },
+        { "noinit",   (uint32_t)&__start_noinit, (uint32_t)&__stop_noinit - (uint32_t)&__start_noinit },
+        { "heap",     (uint32_t)&__HeapBase,     (uint32_t)&__HeapLimit - (uint32_t)&__HeapBase },
+        { "stack",    (uint32_t)&__StackLimit,   (uint32_t)&__StackTop - (uint32_t)&__StackLimit },
+    };
+
+    uint32_t count = 0;
+    for (; count < max_count && count < sizeof(sections) / sizeof(sections[0]); count++)
+    {
+        p_sections[count] = sections[count];
+    }
+    return count;
+}
@@ -0,0 +1,80 @@
+#include "perf.h"
+
+#if ESTC_PERF_ENABLED
+
+#include "app_util_platform.h"
+#include <string.h>
+
+#define PERF_PROBE_NAME(id, name)   name,
+
+static const char * const m_probe_names[PERF_PROBE_COUNT] = {
+    PERF_PROBE_LIST(PERF_PROBE_NAME)
+};
+
+static perf_stats_t m_stats[PERF_PROBE_COUNT];
+
+void perf_init(void)
+{
+    // Счетчик тактов: трассировка должна быть включена в DEMCR
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    perf_reset();
+}
+
+void perf_record(perf_probe_t probe, uint32_t cycles)
+{
+    // Номер корзины - число значащих бит длительности
+    uint32_t bin = (cycles == 0) ? 0 : (32 - __CLZ(cycles));
+    if (bin >= PERF_HIST_BINS) bin = PERF_HIST_BINS - 1;
+
+    // Точки замера есть и в прерываниях таймеров
+    CRITICAL_REGION_ENTER();
+    perf_stats_t * p_stats = &m_stats[probe];
+
+    p_stats->count++;
+    p_stats->total += cycles;
+    if (cycles < p_stats->min) p_stats->min = cycles;
+    if (cycles > p_stats->max) p_stats->max = cycles;
+    if (p_stats->hist[bin] != UINT16_MAX) p_stats->hist[bin]++;
+    CRITICAL_REGION_EXIT();
+}
+
+bool perf_is_enabled(void)
+{
+    return true;
+}
+
+void perf_get(perf_probe_t probe, perf_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats[probe];
+    CRITICAL_REGION_EXIT();
+}
+
+void perf_reset(void)
+{
+    CRITICAL_REGION_ENTER();
+    memset(m_stats, 0, sizeof(m_stats));
+    for (uint32_t i = 0; i < PERF_PROBE_COUNT; i++)
+    {
+        m_stats[i].min = UINT32_MAX;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+const char * perf_probe_name(perf_probe_t probe)
+{
+    return (probe < PERF_PROBE_COUNT) ? m_probe_names[probe] : "unknown";
+}
+
+#else
+
+void perf_init(void) {}
+bool perf_is_enabled(void) { return false; }
+void perf_get(perf_probe_t probe, perf_stats_t * p_stats) {}
+void perf_reset(void) {}
+const char * perf_probe_name(perf_probe_t probe) { return "unknown"; }
+
+#endif
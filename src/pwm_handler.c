@@ -2,6 +2,9 @@
 #include "nrfx_pwm.h"
 #include "nrf_pwm.h"
 #include "app_timer.h"
+#include "app_util_platform.h"
+#include "perf.h"
+#include "trace.h"
 
 #define PWM_TOP_VALUE       1000
 #define BLINK_SLOW_MS       500
@@ -11,16 +14,93 @@ APP_TIMER_DEF(m_blink_timer);
 
 static nrfx_pwm_t m_pwm_instance = NRFX_PWM_INSTANCE(0);
 static nrf_pwm_values_individual_t m_seq_values;
+static nrf_pwm_sequence_t m_seq;
+static bool m_running = false;
+// Остановка запрошена, событие STOPPED еще не пришло
+static volatile bool m_stopping = false;
 
 static pwm_indicator_mode_t m_indicator_mode = PWM_INDICATOR_OFF;
 static bool m_blink_state = false;
 
+#if ESTC_TRACE_ENABLED
+// Трасса: прерывание SEQEND0 включается только после записи нового цвета,
+// первое событие после записи отмечает его появление на выходе
+// (с точностью до двух периодов ШИМ: значения читаются в начале периода)
+#define PWM_PLAYBACK_FLAGS  (NRFX_PWM_FLAG_LOOP | NRFX_PWM_FLAG_NO_EVT_FINISHED | \
+                             NRFX_PWM_FLAG_SIGNAL_END_SEQ0)
+
+static volatile bool m_trace_armed = false;
+#else
+// Без NO_EVT_FINISHED прерывание LOOPSDONE приходило бы каждые два периода ШИМ
+#define PWM_PLAYBACK_FLAGS  (NRFX_PWM_FLAG_LOOP | NRFX_PWM_FLAG_NO_EVT_FINISHED)
+#endif
+
+static bool pwm_is_dark(void)
+{
+    return (m_seq_values.channel_0 == 0) && (m_seq_values.channel_1 == 0) &&
+           (m_seq_values.channel_2 == 0) && (m_seq_values.channel_3 == 0);
+}
+
+// Останавливает ШИМ при полностью погашенных светодиодах и запускает снова
+// при первом ненулевом значении. Пока ШИМ остановлен, он не запрашивает
+// HFCLK, и в простое остается только LFCLK для app_timer (при
+// ESTC_BUTTON_LOW_POWER=0 HFCLK все равно держит TIMER3 меток кнопок).
+// Остановка не ожидается (до периода ШИМ): если за это время появилось
+// ненулевое значение, запуск выполняет обработчик события STOPPED.
+static void pwm_update_state(void)
+{
+    bool is_dark = pwm_is_dark();
+
+    CRITICAL_REGION_ENTER();
+    if (is_dark && m_running)
+    {
+        m_stopping = true;
+        m_running = false;
+        nrfx_pwm_stop(&m_pwm_instance, false);
+    }
+    else if (!is_dark && !m_running && !m_stopping)
+    {
+        nrfx_pwm_simple_playback(&m_pwm_instance, &m_seq, 1, PWM_PLAYBACK_FLAGS);
+        m_running = true;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+static void pwm_event_handler(nrfx_pwm_evt_type_t event_type)
+{
+    switch (event_type)
+    {
+        case NRFX_PWM_EVT_STOPPED:
+            // Значения могли стать ненулевыми, пока шла остановка
+            m_stopping = false;
+            pwm_update_state();
+            break;
+
+#if ESTC_TRACE_ENABLED
+        case NRFX_PWM_EVT_END_SEQ0:
+            nrf_pwm_int_disable(m_pwm_instance.p_registers, NRF_PWM_INT_SEQEND0_MASK);
+            if (m_trace_armed)
+            {
+                m_trace_armed = false;
+                TRACE(PWM_OUTPUT, 0, 0);
+            }
+            break;
+#endif
+
+        default:
+            break;
+    }
+}
+
 // Таймер мигания
 static void blink_timer_handler(void *p_context)
 {
+    PERF_BEGIN(TMR_BLINK);
     // Инвертируем состояние для мигания
     m_blink_state = !m_blink_state;
     m_seq_values.channel_0 = m_blink_state ? PWM_TOP_VALUE : 0;
+    pwm_update_state();
+    PERF_END(TMR_BLINK);
 }
 
 // Инициализация ШИМ
@@ -28,16 +108,17 @@ void pwm_handler_init(const uint32_t *led_pins)
 {
     nrfx_pwm_config_t config = NRFX_PWM_DEFAULT_CONFIG;
     
-    // Настройка пинов
+    // Настройка пинов. Светодиоды активны по низкому уровню: после остановки ШИМ
+    // на пинах остается высокий уровень (NRFX_PWM_PIN_INVERTED), светодиоды погашены
     for (int i = 0; i < 4; i++) {
-        config.output_pins[i] = (led_pins[i] != NRF_PWM_PIN_NOT_CONNECTED) ? led_pins[i] : NRFX_PWM_PIN_NOT_USED;
+        config.output_pins[i] = (led_pins[i] != NRF_PWM_PIN_NOT_CONNECTED) ? (led_pins[i] | NRFX_PWM_PIN_INVERTED) : NRFX_PWM_PIN_NOT_USED;
     }
 
     config.top_value = PWM_TOP_VALUE;
     config.load_mode = NRF_PWM_LOAD_INDIVIDUAL; 
     config.step_mode = NRF_PWM_STEP_AUTO;
 
-    nrfx_pwm_init(&m_pwm_instance, &config, NULL);
+    nrfx_pwm_init(&m_pwm_instance, &config, pwm_event_handler);
 
     // Сброс значений каналов
     m_seq_values.channel_0 = 0;
@@ -47,13 +128,12 @@ void pwm_handler_init(const uint32_t *led_pins)
 
     app_timer_create(&m_blink_timer, APP_TIMER_MODE_REPEATED, blink_timer_handler);
     
-    nrf_pwm_sequence_t seq;
-    seq.values.p_individual = &m_seq_values;
-    seq.length              = 4;
-    seq.repeats             = 0;
-    seq.end_delay           = 0;
-    // Запуск циклического воспроизведения
-    nrfx_pwm_simple_playback(&m_pwm_instance, &seq, 1, NRFX_PWM_FLAG_LOOP);
+    m_seq.values.p_individual = &m_seq_values;
+    m_seq.length              = 4;
+    m_seq.repeats             = 0;
+    m_seq.end_delay           = 0;
+    // Циклическое воспроизведение запускается при первом ненулевом значении
+    pwm_update_state();
 }
 
 // Установка RGB
@@ -62,6 +142,22 @@ void pwm_handler_set_rgb(uint16_t r, uint16_t g, uint16_t b)
     m_seq_values.channel_1 = (r > PWM_TOP_VALUE) ? PWM_TOP_VALUE : r;
     m_seq_values.channel_2 = (g > PWM_TOP_VALUE) ? PWM_TOP_VALUE : g;
     m_seq_values.channel_3 = (b > PWM_TOP_VALUE) ? PWM_TOP_VALUE : b;
+    pwm_update_state();
+
+#if ESTC_TRACE_ENABLED
+    if (!pwm_is_dark())
+    {
+        // Ждем первого SEQEND после записи (или после перезапуска по STOPPED)
+        m_trace_armed = true;
+        nrf_pwm_event_clear(m_pwm_instance.p_registers, NRF_PWM_EVENT_SEQEND0);
+        nrf_pwm_int_enable(m_pwm_instance.p_registers, NRF_PWM_INT_SEQEND0_MASK);
+    }
+    else
+    {
+        // Все погашено, ШИМ остановлен
+        TRACE(PWM_OUTPUT, 0, 1);
+    }
+#endif
 }
 
 // Устанавливает режим работы индикатора (мигание/постоянный)
@@ -85,4 +181,10 @@ void pwm_handler_set_indicator_mode(pwm_indicator_mode_t mode)
             app_timer_start(m_blink_timer, APP_TIMER_TICKS(BLINK_FAST_MS), NULL);
             break;
     }
-}
\ No newline at end of file
+    pwm_update_state();
+}
+
+bool pwm_handler_is_running(void)
+{
+    return m_running;
+}
@@ -0,0 +1,110 @@
+#include "trace.h"
+
+#if ESTC_TRACE_ENABLED
+
+#include "button_handler.h"
+#include "app_util_platform.h"
+
+#define TRACE_MAGIC     0x54524331  // "TRC1"
+
+typedef struct
+{
+    uint32_t       magic;
+    uint32_t       head;            // Индекс следующей записи
+    uint32_t       count;
+    trace_record_t records[TRACE_BUF_SIZE];
+} trace_buffer_t;
+
+// Не обнуляется при старте: трасса доступна после программного сброса
+static trace_buffer_t m_trace __attribute__((section(".noinit")));
+
+static volatile bool m_paused = false;
+
+static const char * const m_stage_names[TRACE_STAGE_COUNT] = {
+    "boot", "btn_edge", "btn_debounce", "app_event", "update_leds", "pwm_output", "cli_rx", "cli_handler",
+    "hid_rx"
+};
+
+uint32_t trace_time_us(void)
+{
+    return button_handler_time_us();
+}
+
+void trace_record(trace_stage_t stage, uint32_t time_us, uint8_t id, uint16_t arg)
+{
+    if (m_paused) return;
+
+    // Записи приходят из прерываний и основного цикла
+    CRITICAL_REGION_ENTER();
+    trace_record_t * p_record = &m_trace.records[m_trace.head];
+
+    p_record->time_us = time_us;
+    p_record->stage   = stage;
+    p_record->id      = id;
+    p_record->arg     = arg;
+
+    m_trace.head = (m_trace.head + 1) % TRACE_BUF_SIZE;
+    if (m_trace.count < TRACE_BUF_SIZE) m_trace.count++;
+    CRITICAL_REGION_EXIT();
+}
+
+void trace_init(void)
+{
+    // После включения питания содержимое случайно
+    if (m_trace.magic != TRACE_MAGIC || m_trace.head >= TRACE_BUF_SIZE || m_trace.count > TRACE_BUF_SIZE)
+    {
+        trace_clear();
+    }
+
+    TRACE(BOOT, 0, 0);
+}
+
+bool trace_is_enabled(void)
+{
+    return true;
+}
+
+void trace_pause(bool pause)
+{
+    m_paused = pause;
+}
+
+uint32_t trace_count(void)
+{
+    return m_trace.count;
+}
+
+bool trace_get(uint32_t index, trace_record_t * p_record)
+{
+    if (index >= m_trace.count) return false;
+
+    uint32_t first = (m_trace.head + TRACE_BUF_SIZE - m_trace.count) % TRACE_BUF_SIZE;
+    *p_record = m_trace.records[(first + index) % TRACE_BUF_SIZE];
+    return true;
+}
+
+void trace_clear(void)
+{
+    CRITICAL_REGION_ENTER();
+    m_trace.magic = TRACE_MAGIC;
+    m_trace.head  = 0;
+    m_trace.count = 0;
+    CRITICAL_REGION_EXIT();
+}
+
+const char * trace_stage_name(trace_stage_t stage)
+{
+    return (stage < TRACE_STAGE_COUNT) ? m_stage_names[stage] : "unknown";
+}
+
+#else
+
+void trace_init(void) {}
+bool trace_is_enabled(void) { return false; }
+void trace_pause(bool pause) {}
+uint32_t trace_count(void) { return 0; }
+bool trace_get(uint32_t index, trace_record_t * p_record) { return false; }
+void trace_clear(void) {}
+const char * trace_stage_name(trace_stage_t stage) { return "unknown"; }
+
+#endif
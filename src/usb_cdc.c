@@ -0,0 +1,231 @@
+#include "usb_cdc.h"
+#include <string.h>
+
+#if ESTC_USB_CLI_ENABLED
+
+#include "app_usbd_cdc_acm.h"
+#include "app_util_platform.h"
+#include "button_handler.h"
+#include "perf.h"
+#include "sdk_config.h"
+
+#define RX_MASK     (USB_CDC_RX_BLOCKS - 1)
+
+static void cdc_acm_user_ev_handler(app_usbd_class_inst_t const * p_inst,
+                                    app_usbd_cdc_acm_user_event_t event);
+
+// Номера интерфейсов и конечных точек - из настроек CLI CDC ACM
+APP_USBD_CDC_ACM_GLOBAL_DEF(m_cdc_acm,
+                            cdc_acm_user_ev_handler,
+                            NRF_CLI_CDC_ACM_COMM_INTERFACE,
+                            NRF_CLI_CDC_ACM_DATA_INTERFACE,
+                            NRF_CLI_CDC_ACM_COMM_EPIN,
+                            NRF_CLI_CDC_ACM_DATA_EPIN,
+                            NRF_CLI_CDC_ACM_DATA_EPOUT,
+                            APP_USBD_CDC_COMM_PROTOCOL_AT_V250);
+
+// Кольцо блоков: head заполняет прерывание USB, tail освобождает основной цикл
+static uint8_t           m_rx_blocks[USB_CDC_RX_BLOCKS][USB_CDC_RX_BLOCK_SIZE];
+static uint8_t           m_rx_length[USB_CDC_RX_BLOCKS];
+static volatile uint32_t m_rx_head;
+static volatile uint32_t m_rx_tail;
+static uint32_t          m_rx_pos;          // Прочитано байт в блоке tail
+static volatile bool     m_rx_armed = false; // Прием в блок head запущен
+
+static volatile bool     m_port_open = false;
+
+// Передача идет по DMA прямо из буфера: данные копируются в свой буфер пакета,
+// и вызывающий может сразу переиспользовать свой
+static uint8_t           m_tx_buf[USB_CDC_RX_BLOCK_SIZE];
+static volatile bool     m_tx_busy = false;
+static usb_cdc_handler_t m_handler;
+
+static usb_cdc_stats_t   m_stats;
+static uint32_t          m_stats_start_us;
+
+// Блок head заполнен. Пакет нулевой длины (ZLP) блок не занимает: пустой
+// блок в очереди остановил бы разбор (usb_cdc_rx_peek() вернул бы 0),
+// прием перезапускается в тот же блок
+static void rx_block_done(size_t length)
+{
+    if (length == 0) return;
+
+    m_rx_length[m_rx_head & RX_MASK] = (uint8_t)length;
+    m_rx_head++;
+
+    m_stats.rx_bytes += length;
+    m_stats.rx_packets++;
+}
+
+// Запуск приема в свободный блок. Вызывается из прерывания USB
+// или при запрещенных прерываниях
+static void rx_arm(void)
+{
+    while (m_rx_head - m_rx_tail < USB_CDC_RX_BLOCKS)
+    {
+        ret_code_t ret = app_usbd_cdc_acm_read_any(&m_cdc_acm,
+                                                   m_rx_blocks[m_rx_head & RX_MASK],
+                                                   USB_CDC_RX_BLOCK_SIZE);
+        if (ret == NRF_SUCCESS)
+        {
+            // Данные уже были в буфере класса: блок заполнен сразу, без события RX_DONE
+            rx_block_done(app_usbd_cdc_acm_rx_size(&m_cdc_acm));
+            continue;
+        }
+
+        // BUSY - прием уже запущен (повторное открытие порта)
+        m_rx_armed = (ret == NRF_ERROR_IO_PENDING) || (ret == NRF_ERROR_BUSY);
+        return;
+    }
+
+    // Все блоки заняты: хост ждет, пока основной цикл разберет данные
+    m_rx_armed = false;
+    m_stats.rx_stalls++;
+}
+
+static void cdc_acm_user_ev_handler(app_usbd_class_inst_t const * p_inst,
+                                    app_usbd_cdc_acm_user_event_t event)
+{
+    switch (event)
+    {
+        case APP_USBD_CDC_ACM_USER_EVT_PORT_OPEN:
+            m_port_open = true;
+            if (!m_rx_armed)
+            {
+                rx_arm();
+            }
+            break;
+
+        case APP_USBD_CDC_ACM_USER_EVT_PORT_CLOSE:
+            m_port_open = false;
+            m_tx_busy = false;
+            m_handler(USB_CDC_EVT_PORT_CLOSED);
+            break;
+
+        case APP_USBD_CDC_ACM_USER_EVT_TX_DONE:
+            m_tx_busy = false;
+            m_handler(USB_CDC_EVT_TX_DONE);
+            break;
+
+        case APP_USBD_CDC_ACM_USER_EVT_RX_DONE:
+        {
+            PERF_BEGIN(USB_RX_EVT);
+            rx_block_done(app_usbd_cdc_acm_rx_size(&m_cdc_acm));
+            rx_arm();
+            PERF_END(USB_RX_EVT);
+
+            m_handler(USB_CDC_EVT_RX);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void usb_cdc_init(usb_cdc_handler_t handler)
+{
+    m_handler = handler;
+    m_stats_start_us = button_handler_time_us();
+}
+
+app_usbd_class_inst_t const * usb_cdc_class_inst(void)
+{
+    return app_usbd_cdc_acm_class_inst_get(&m_cdc_acm);
+}
+
+size_t usb_cdc_rx_peek(uint8_t const ** pp_data)
+{
+    if (m_rx_head == m_rx_tail) return 0;
+
+    uint32_t index = m_rx_tail & RX_MASK;
+    *pp_data = &m_rx_blocks[index][m_rx_pos];
+    return m_rx_length[index] - m_rx_pos;
+}
+
+void usb_cdc_rx_consume(size_t length)
+{
+    if (m_rx_head == m_rx_tail) return;
+
+    m_rx_pos += length;
+    if (m_rx_pos < m_rx_length[m_rx_tail & RX_MASK]) return;
+
+    // Блок разобран полностью
+    m_rx_pos = 0;
+    m_rx_tail++;
+
+    CRITICAL_REGION_ENTER();
+    if (!m_rx_armed && m_port_open)
+    {
+        rx_arm();
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+ret_code_t usb_cdc_write(void const * p_data, size_t length, size_t * p_cnt)
+{
+    if (!m_port_open)
+    {
+        // Терминал не открыт: вывод отбрасывается, как в nrf_cli_cdc_acm
+        *p_cnt = length;
+        return NRF_SUCCESS;
+    }
+    if (m_tx_busy)
+    {
+        *p_cnt = 0;
+        return NRF_SUCCESS;
+    }
+
+    // За один вызов - не больше пакета
+    size_t count = (length > sizeof(m_tx_buf)) ? sizeof(m_tx_buf) : length;
+    memcpy(m_tx_buf, p_data, count);
+
+    // Флаг ставится до запуска: TX_DONE может прийти раньше возврата из записи
+    m_tx_busy = true;
+    ret_code_t ret = app_usbd_cdc_acm_write(&m_cdc_acm, m_tx_buf, count);
+    if (ret == NRF_SUCCESS)
+    {
+        *p_cnt = count;
+        return NRF_SUCCESS;
+    }
+
+    m_tx_busy = false;
+    if (ret == NRF_ERROR_INVALID_STATE)
+    {
+        // Порт закрыт хостом, данные отброшены
+        *p_cnt = count;
+        return NRF_SUCCESS;
+    }
+    if (ret == NRF_ERROR_BUSY)
+    {
+        *p_cnt = 0;
+        return NRF_SUCCESS;
+    }
+    return ret;
+}
+
+void usb_cdc_get_stats(usb_cdc_stats_t * p_stats, bool reset)
+{
+    uint32_t now_us = button_handler_time_us();
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats;
+    p_stats->elapsed_us = now_us - m_stats_start_us;
+    if (reset)
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+        m_stats_start_us = now_us;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+#else
+
+void usb_cdc_init(usb_cdc_handler_t handler) {}
+app_usbd_class_inst_t const * usb_cdc_class_inst(void) { return NULL; }
+size_t usb_cdc_rx_peek(uint8_t const ** pp_data) { return 0; }
+void usb_cdc_rx_consume(size_t length) {}
+ret_code_t usb_cdc_write(void const * p_data, size_t length, size_t * p_cnt) { *p_cnt = length; return NRF_SUCCESS; }
+void usb_cdc_get_stats(usb_cdc_stats_t * p_stats, bool reset) { memset(p_stats, 0, sizeof(*p_stats)); }
+
+#endif
@@ -3,45 +3,455 @@
 #if ESTC_USB_CLI_ENABLED
 
 #include "nrf_cli.h"
-#include "nrf_cli_cdc_acm.h"
 #include "app_logic.h"
+#include "button_handler.h"
+#include "perf.h"
+#include "trace.h"
+#include "mem_monitor.h"
+#include "bin_proto.h"
+#include "color_stream.h"
+#include "usb_cdc.h"
+#include "usb_hid.h"
+#include "cli_parse.h"
+#include "ws2812_handler.h"
+#if ESTC_USB_CLI_COMPACT
+#include "cli_compact.h"
+#endif
 #include "nrf_log.h"
+#include "nrf_fprintf.h"
 #include "app_usbd.h"
 #include "app_usbd_core.h"
 #include "app_usbd_serial_num.h"
-#include <stdlib.h>
 #include <string.h>
 
-// Настройки CLI
-NRF_CLI_CDC_ACM_DEF(m_cli_cdc_acm_transport);
+// Транспорт CLI поверх usb_cdc: разделяет входящий поток на текст для CLI,
+// кадры двоичного протокола (bin_proto.h) и потоковые кадры (color_stream.h).
+// Данные разбираются прямо в блоках приема usb_cdc, CLI получает только текст.
+// С ESTC_TRACE_ENABLED отмечает в трассе получение конца строки команды.
+// С ESTC_USB_CLI_COMPACT команды разбирает cli_compact.h вместо nrf_cli.
 
+// Приглашение CLI
+#define CLI_PROMPT          "usb_cli:~$ "
+
+// Буфер ответов двоичного протокола
+#define BIN_TX_BUF_SIZE     64
+
+static nrf_cli_transport_handler_t m_cli_evt_handler;
+static void *                      m_cli_evt_context;
+
+// Приглашение CLI; в машинном режиме пустое
+static char m_prompt[] = CLI_PROMPT;
+
+#if !ESTC_USB_CLI_COMPACT
+// Эхо и цвета nrf_cli переключаются только встроенными командами cli:
+// транспорт подает их на вход CLI вместо принятых данных, их вывод
+// отбрасывается до следующего чтения после последней команды
+static const char * m_p_inject = NULL;
+static bool         m_inject_mute = false;
+#endif
+
+// Строка с ';' - пакет команд: запись во Flash выполняется один раз после
+// последней команды строки
+static bool m_batch_line = false;
+static bool m_batch_end_pending = false;
+
+// Порт закрыт или USB приостановлена (из прерывания): потоковый режим
+// завершается в основном цикле, иначе после переподключения CLI не ответит
+static volatile bool m_port_lost = false;
+
+// Ответы копятся и уходят передачами по пакету после разбора порции.
+// Передатчик не ожидается: остаток уходит в следующих проходах основного
+// цикла (после USB_CDC_EVT_TX_DONE)
+static uint8_t  m_bin_tx_buf[BIN_TX_BUF_SIZE];
+static size_t   m_bin_tx_len;
+
+static void bin_tx_flush(void)
+{
+    size_t sent = 0;
+
+    while (sent < m_bin_tx_len)
+    {
+        size_t cnt = 0;
+        if (usb_cdc_write(&m_bin_tx_buf[sent], m_bin_tx_len - sent, &cnt) != NRF_SUCCESS)
+        {
+            // Ошибка USB: ответы уже не доставить
+            sent = m_bin_tx_len;
+            break;
+        }
+        // Передатчик занят предыдущим ответом или выводом CLI
+        if (cnt == 0) break;
+        sent += cnt;
+    }
+
+    m_bin_tx_len -= sent;
+    memmove(m_bin_tx_buf, &m_bin_tx_buf[sent], m_bin_tx_len);
+}
+
+static bool bin_tx_write(uint8_t const * p_data, size_t length)
+{
+    if (m_bin_tx_len + length > BIN_TX_BUF_SIZE)
+    {
+        bin_tx_flush();
+    }
+    // Хост шлет кадры быстрее, чем читает ответы: ответ отбрасывается (bin_stats)
+    if (m_bin_tx_len + length > BIN_TX_BUF_SIZE) return false;
+
+    memcpy(&m_bin_tx_buf[m_bin_tx_len], p_data, length);
+    m_bin_tx_len += length;
+    return true;
+}
+
+// Конец потока: состояние app_logic догоняет цвет на светодиодах
+static void stream_finish(void)
+{
+    uint16_t r, g, b;
+    color_stream_stop(&r, &g, &b);
+
+    app_logic_render_invalidate();
+    app_logic_show_rgb(r, g, b);
+}
+
+// Отложенный вывод длинных ответов (list_colors, trace): обработчик только
+// запускает вывод, строки формируются в основном цикле по мере освобождения
+// передатчика USB. Пока вывод не закончен, команды не читаются, а вывод CLI
+// (приглашение) отбрасывается - приглашение выводится после последней строки
+
+// Самая длинная строка вывода
+#define PAGE_LINE_MAX       64
+#define PAGE_BUF_SIZE       (2 * PAGE_LINE_MAX)
+
+// Вывод строки index через page_printf(); нет строки - ничего не выводит
+typedef void (*page_line_fn_t)(uint32_t index);
+
+static page_line_fn_t m_page_line_fn;       // NULL - строки сформированы
+static void (*m_page_done_fn)(void);
+static uint32_t m_page_index;
+static uint32_t m_page_end;
+static uint8_t  m_page_buf[PAGE_BUF_SIZE];
+static size_t   m_page_len;
+
+static void page_fwrite(void const * p_user_ctx, char const * p_str, size_t length)
+{
+    size_t count = MIN(length, PAGE_BUF_SIZE - m_page_len);
+    memcpy(&m_page_buf[m_page_len], p_str, count);
+    m_page_len += count;
+}
+
+static char m_page_fmt_buf[16];
+NRF_FPRINTF_DEF(m_page_fprintf_ctx, NULL, m_page_fmt_buf, sizeof(m_page_fmt_buf), true, page_fwrite);
+
+#define page_printf(...)    nrf_fprintf(&m_page_fprintf_ctx, __VA_ARGS__)
+
+// Вывод строк [first, end) после уже сформированного page_printf() заголовка
+static void page_start(page_line_fn_t line_fn, uint32_t first, uint32_t end, void (*done_fn)(void))
+{
+    m_page_index   = first;
+    m_page_end     = end;
+    m_page_done_fn = done_fn;
+    m_page_line_fn = line_fn;
+}
+
+static bool page_is_active(void)
+{
+    return (m_page_line_fn != NULL) || (m_page_len != 0);
+}
+
+// Не больше одной передачи за вызов, передатчик не ожидается
+static void page_process(void)
+{
+    if (m_page_line_fn != NULL)
+    {
+        while ((m_page_index < m_page_end) && (PAGE_BUF_SIZE - m_page_len >= PAGE_LINE_MAX))
+        {
+            m_page_line_fn(m_page_index++);
+        }
+
+        if ((m_page_index == m_page_end) && (PAGE_BUF_SIZE - m_page_len >= sizeof(CLI_PROMPT)))
+        {
+            if (m_page_done_fn != NULL)
+            {
+                m_page_done_fn();
+            }
+            page_fwrite(NULL, m_prompt, strlen(m_prompt));
+            m_page_line_fn = NULL;
+        }
+    }
+
+    if (m_page_len != 0)
+    {
+        // 0 байт - передатчик занят, продолжим после USB_CDC_EVT_TX_DONE
+        size_t cnt = 0;
+        if (usb_cdc_write(m_page_buf, m_page_len, &cnt) != NRF_SUCCESS)
+        {
+            cnt = m_page_len;
+        }
+        m_page_len -= cnt;
+        memmove(m_page_buf, &m_page_buf[cnt], m_page_len);
+    }
+}
+
+// События порта передаются CLI (из прерывания USB)
+static void usb_cdc_evt_handler(usb_cdc_evt_t event)
+{
+    if (event == USB_CDC_EVT_PORT_CLOSED)
+    {
+        m_port_lost = true;
+        return;
+    }
+
+    if (m_cli_evt_handler == NULL) return;
+
+    m_cli_evt_handler((event == USB_CDC_EVT_RX) ? NRF_CLI_TRANSPORT_EVT_RX_RDY : NRF_CLI_TRANSPORT_EVT_TX_RDY,
+                      m_cli_evt_context);
+}
+
+static ret_code_t mux_transport_init(nrf_cli_transport_t const * p_transport,
+                                     void const * p_config,
+                                     nrf_cli_transport_handler_t evt_handler,
+                                     void * p_context)
+{
+    m_cli_evt_handler = evt_handler;
+    m_cli_evt_context = p_context;
+
+    bin_proto_init(bin_tx_write);
+    usb_cdc_init(usb_cdc_evt_handler);
+    return NRF_SUCCESS;
+}
+
+static ret_code_t mux_transport_uninit(nrf_cli_transport_t const * p_transport)
+{
+    m_cli_evt_handler = NULL;
+    return NRF_SUCCESS;
+}
+
+static ret_code_t mux_transport_enable(nrf_cli_transport_t const * p_transport, bool blocking)
+{
+    // Блокирующий вывод через USB не поддерживается (как в nrf_cli_cdc_acm)
+    return blocking ? NRF_ERROR_NOT_SUPPORTED : NRF_SUCCESS;
+}
+
+static ret_code_t mux_transport_write(nrf_cli_transport_t const * p_transport,
+                                      const void * p_data, size_t length, size_t * p_cnt)
+{
+#if !ESTC_USB_CLI_COMPACT
+    if (m_inject_mute)
+    {
+        *p_cnt = length;
+        return NRF_SUCCESS;
+    }
+#endif
+    if (page_is_active())
+    {
+        *p_cnt = length;
+        return NRF_SUCCESS;
+    }
+    return usb_cdc_write(p_data, length, p_cnt);
+}
+
+// Конец строки по правилу nrf_cli (process_nl): '\r' или '\n', второй символ
+// пары CRLF/LFCR строку не завершает
+static uint8_t m_last_nl = 0;
+
+static bool is_line_end(uint8_t byte)
+{
+    if ((byte != '\r') && (byte != '\n'))
+    {
+        m_last_nl = 0;
+        return false;
+    }
+    if ((m_last_nl == 0) || (byte == m_last_nl))
+    {
+        m_last_nl = byte;
+        return true;
+    }
+    return false;
+}
+
+// CLI читает, пока не получит 0 байт. Двоичные и потоковые кадры разбираются
+// здесь же, поэтому 0 возвращается только когда принятых данных больше нет
+// или идет отложенный вывод. За одно чтение CLI получает не больше одной
+// строки: команда может запустить отложенный вывод
+static ret_code_t mux_transport_read(nrf_cli_transport_t const * p_transport,
+                                     void * p_data, size_t length, size_t * p_cnt)
+{
+    uint8_t * p_out = p_data;
+    uint8_t const * p_rx;
+    size_t available;
+    bool line_end = false;
+
+    *p_cnt = 0;
+    if (page_is_active()) return NRF_SUCCESS;
+
+#if !ESTC_USB_CLI_COMPACT
+    if (m_p_inject != NULL)
+    {
+        if (*m_p_inject != '\0')
+        {
+            while ((*p_cnt < length) && (*m_p_inject != '\0'))
+            {
+                uint8_t byte = *m_p_inject++;
+                p_out[(*p_cnt)++] = byte;
+                if (byte == '\r') break;
+            }
+            return NRF_SUCCESS;
+        }
+
+        // Команды выполнены; заглушенное приглашение выводится заново,
+        // чтение продолжится после его передачи
+        m_p_inject    = NULL;
+        m_inject_mute = false;
+        page_fwrite(NULL, m_prompt, strlen(m_prompt));
+        if (page_is_active()) return NRF_SUCCESS;
+    }
+#endif
+
+    PERF_BEGIN(USB_RX_PARSE);
+    while ((*p_cnt < length) && !line_end && ((available = usb_cdc_rx_peek(&p_rx)) != 0))
+    {
+        size_t used = 0;
+
+        if (color_stream_is_active())
+        {
+            // Потоковые кадры разбираются целым блоком
+            if (!color_stream_rx(p_rx, available, &used))
+            {
+                stream_finish();
+            }
+        }
+        else
+        {
+            while ((used < available) && (*p_cnt < length) && !line_end)
+            {
+                uint8_t byte = p_rx[used++];
+                if (bin_proto_rx_byte(byte)) continue;
+
+                bool separator = (byte == ';');
+                if (separator)
+                {
+                    // Разделитель команд в строке: для CLI - конец команды
+                    if (!m_batch_line)
+                    {
+                        m_batch_line = true;
+                        app_logic_batch_begin();
+                    }
+                    byte = '\r';
+                }
+
+                if (is_line_end(byte))
+                {
+                    if (!separator && m_batch_line)
+                    {
+                        // Последняя команда пакета выполнится до возврата из nrf_cli_process()
+                        m_batch_line = false;
+                        m_batch_end_pending = true;
+                    }
+                    TRACE(CLI_RX, 0, 0);
+                    line_end = true;
+                }
+                if (separator)
+                {
+                    // Разделитель не образует пару CRLF: перевод строки после
+                    // ';' завершает пакет
+                    m_last_nl = 0;
+                }
+                p_out[(*p_cnt)++] = byte;
+            }
+        }
+        usb_cdc_rx_consume(used);
+    }
+
+    bin_tx_flush();
+    PERF_END(USB_RX_PARSE);
+    return NRF_SUCCESS;
+}
+
+static const nrf_cli_transport_api_t m_mux_transport_api = {
+    .init   = mux_transport_init,
+    .uninit = mux_transport_uninit,
+    .enable = mux_transport_enable,
+    .write  = mux_transport_write,
+    .read   = mux_transport_read
+};
+
+static const nrf_cli_transport_t m_mux_transport = {
+    .p_api = &m_mux_transport_api
+};
+
+#if !ESTC_USB_CLI_COMPACT
 NRF_CLI_DEF(m_cli_cdc_acm,
-            "usb_cli:~$ ", 
-            &m_cli_cdc_acm_transport.transport,
+            m_prompt,
+            &m_mux_transport,
             '\r', 
             4);
+#endif
 
 // Обработчики команд
 
-// Команда RGB
-static void cmd_rgb(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+// Числовой аргумент; при ошибке выводит, какой аргумент и почему не принят
+static bool arg_uint(nrf_cli_t const * p_cli, const char * p_name, const char * p_arg,
+                     uint32_t min, uint32_t max, uint32_t * p_value)
 {
-    if (argc != 4)
+    cli_parse_result_t res = cli_parse_uint(p_arg, min, max, p_value);
+    if (res.status == CLI_PARSE_OK) return true;
+
+    if (res.status == CLI_PARSE_OUT_OF_RANGE)
     {
-        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: RGB <r> <g> <b>\n");
-        return;
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Error: %s '%s' out of range %u-%u\n", p_name, p_arg, min, max);
+    }
+    else
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Error: %s '%s': %s at position %u\n",
+                        p_name, p_arg, cli_parse_status_str(res.status), res.offset);
+    }
+    return false;
+}
+
+// Цвет RGB 0-255: один аргумент #RRGGBB или три числа
+static bool arg_rgb(nrf_cli_t const * p_cli, char ** argv, size_t count,
+                    uint32_t * p_r, uint32_t * p_g, uint32_t * p_b)
+{
+    if (count == 1)
+    {
+        uint8_t r, g, b;
+        cli_parse_result_t res = cli_parse_color(argv[0], &r, &g, &b);
+        if (res.status != CLI_PARSE_OK)
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Error: color '%s': %s at position %u\n",
+                            argv[0], cli_parse_status_str(res.status), res.offset);
+            return false;
+        }
+        *p_r = r;
+        *p_g = g;
+        *p_b = b;
+        return true;
     }
 
-    uint32_t r_in = atoi(argv[1]);
-    uint32_t g_in = atoi(argv[2]);
-    uint32_t b_in = atoi(argv[3]);
+    return arg_uint(p_cli, "r", argv[0], 0, 255, p_r) &&
+           arg_uint(p_cli, "g", argv[1], 0, 255, p_g) &&
+           arg_uint(p_cli, "b", argv[2], 0, 255, p_b);
+}
 
-    if (r_in > 255 || g_in > 255 || b_in > 255)
+// Цвет HSV из трех аргументов
+static bool arg_hsv(nrf_cli_t const * p_cli, char ** argv,
+                    uint32_t * p_h, uint32_t * p_s, uint32_t * p_v)
+{
+    return arg_uint(p_cli, "h", argv[0], 0, 360, p_h) &&
+           arg_uint(p_cli, "s", argv[1], 0, 100, p_s) &&
+           arg_uint(p_cli, "v", argv[2], 0, 100, p_v);
+}
+
+// Команда RGB
+static void cmd_rgb(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if (argc != 4 && argc != 2)
     {
-        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Error: Values must be 0-255\n");
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: RGB <r> <g> <b> | RGB #RRGGBB\n");
         return;
     }
 
+    uint32_t r_in, g_in, b_in;
+    if (!arg_rgb(p_cli, &argv[1], argc - 1, &r_in, &g_in, &b_in)) return;
+
     // Масштабируем 0-255 -> 0-1000
     uint16_t r = (r_in * 1000) / 255;
     uint16_t g = (g_in * 1000) / 255;
@@ -60,9 +470,9 @@ static void cmd_hsv(nrf_cli_t const * p_cli, size_t argc, char ** argv)
         nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: HSV <h> <s> <v>\n");
         return;
     }
-    uint16_t h = atoi(argv[1]);
-    uint8_t s = atoi(argv[2]);
-    uint8_t v = atoi(argv[3]);
+
+    uint32_t h, s, v;
+    if (!arg_hsv(p_cli, &argv[1], &h, &s, &v)) return;
     
     app_logic_set_hsv(h, s, v);
     
@@ -71,17 +481,21 @@ static void cmd_hsv(nrf_cli_t const * p_cli, size_t argc, char ** argv)
 
 static void cmd_add_rgb_color(nrf_cli_t const * p_cli, size_t argc, char ** argv)
 {
-    if (argc != 5) {
-        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: add_rgb_color <r> <g> <b> <name>\n");
+    if (argc != 5 && argc != 3) {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: add_rgb_color <r> <g> <b> <name> | add_rgb_color #RRGGBB <name>\n");
         return;
     }
     
-    uint16_t r = (atoi(argv[1]) * 1000) / 255;
-    uint16_t g = (atoi(argv[2]) * 1000) / 255;
-    uint16_t b = (atoi(argv[3]) * 1000) / 255;
+    uint32_t r_in, g_in, b_in;
+    if (!arg_rgb(p_cli, &argv[1], argc - 2, &r_in, &g_in, &b_in)) return;
+
+    uint16_t r = (r_in * 1000) / 255;
+    uint16_t g = (g_in * 1000) / 255;
+    uint16_t b = (b_in * 1000) / 255;
+    const char * name = argv[argc - 1];
     
-    if (app_logic_save_color_rgb(r, g, b, argv[4])) {
-        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Color '%s' saved.\n", argv[4]);
+    if (app_logic_save_color_rgb(r, g, b, name)) {
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Color '%s' saved.\n", name);
     } else {
         nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Error: Storage full (max 10) or color already exist.\n");
     }
@@ -94,9 +508,8 @@ static void cmd_add_hsv_color(nrf_cli_t const * p_cli, size_t argc, char ** argv
         return;
     }
     
-    uint16_t h = atoi(argv[1]);
-    uint8_t s = atoi(argv[2]);
-    uint8_t v = atoi(argv[3]);
+    uint32_t h, s, v;
+    if (!arg_hsv(p_cli, &argv[1], &h, &s, &v)) return;
     
     if (app_logic_save_color_hsv(h, s, v, argv[4])) {
         nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Color '%s' saved.\n", argv[4]);
@@ -145,42 +558,498 @@ static void cmd_apply_color(nrf_cli_t const * p_cli, size_t argc, char ** argv)
     }
 }
 
-static void cmd_list_colors(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+static void list_colors_line(uint32_t index)
 {
     uint8_t count = 0;
     const saved_color_entry_t * list = app_logic_get_list(&count);
-    
-    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Saved colors (%d/10):\n", count);
-    for (int i = 0; i < count; i++) {
-        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%d) %s [H:%d S:%d V:%d]\n", 
-                        i+1, list[i].name, list[i].color.h, list[i].color.s, list[i].color.v);
+
+    if (index < count) {
+        page_printf("%u) %s [H:%d S:%d V:%d]\n",
+                    index + 1, list[index].name, list[index].color.h, list[index].color.s, list[index].color.v);
     }
 }
 
+static void cmd_list_colors(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    uint32_t offset = 0;
+    uint32_t limit  = UINT16_MAX;
+
+    if (argc > 3) {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: list_colors [<offset> [<limit>]]\n");
+        return;
+    }
+    if ((argc >= 2) && !arg_uint(p_cli, "offset", argv[1], 0, UINT16_MAX, &offset)) return;
+    if ((argc == 3) && !arg_uint(p_cli, "limit", argv[2], 1, UINT16_MAX, &limit)) return;
+
+    uint8_t count = 0;
+    app_logic_get_list(&count);
+
+    uint32_t first = MIN(offset, count);
+    page_printf("Saved colors (%d/10):\n", count);
+    page_start(list_colors_line, first, MIN(first + limit, count), NULL);
+}
+
+static void cmd_render_stats(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    bool reset = (argc == 2) && (strcmp(argv[1], "reset") == 0);
+    app_logic_render_stats_t stats;
+    app_logic_get_render_stats(&stats, reset);
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Render cache: hits=%u misses=%u pwm_writes=%u\n",
+                    stats.hits, stats.misses, stats.pwm_writes);
+}
+
+// Ресурс страницы nRF52840: 10000 циклов стирания/записи
+#define FLASH_ENDURANCE_CYCLES  10000
+
+static void cmd_flash_stats(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    app_logic_flash_stats_t stats;
+    app_logic_get_flash_stats(&stats);
+
+    uint32_t commits = stats.page_erases + stats.commits_skipped;
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Page erases:     %u (%u.%02u%% of %u endurance)\n",
+                    stats.page_erases,
+                    stats.page_erases * 100 / FLASH_ENDURANCE_CYCLES,
+                    (stats.page_erases * 10000 / FLASH_ENDURANCE_CYCLES) % 100,
+                    FLASH_ENDURANCE_CYCLES);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Words written:   %u\n", stats.words_written);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Commits skipped: %u of %u\n", stats.commits_skipped, commits);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "NVMC time:       %u ms (avg %u ms per erase)\n",
+                    stats.nvmc_time_ms,
+                    (stats.page_erases != 0) ? stats.nvmc_time_ms / stats.page_erases : 0);
+}
+
+static void cmd_button_timing(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    button_timing_t timing;
+
+    if (argc == 5)
+    {
+        uint32_t values[4];
+        static const char * const names[4] = { "debounce", "gap", "long", "repeat" };
+
+        for (int i = 0; i < 4; i++)
+        {
+            if (!arg_uint(p_cli, names[i], argv[1 + i], 0, UINT16_MAX, &values[i])) return;
+        }
+        timing.debounce_ms   = values[0];
+        timing.click_gap_ms  = values[1];
+        timing.long_press_ms = values[2];
+        timing.repeat_ms     = values[3];
+
+        if (!button_handler_set_timing(&timing))
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Error: debounce 1-50, gap 50-2000, long 100-5000, repeat 20-2000\n");
+            return;
+        }
+    }
+    else if (argc != 1)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: button_timing [<debounce> <gap> <long> <repeat>] (ms)\n");
+        return;
+    }
+
+    button_handler_get_timing(&timing);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "debounce=%d gap=%d long=%d repeat=%d ms\n",
+                    timing.debounce_ms, timing.click_gap_ms, timing.long_press_ms, timing.repeat_ms);
+}
+
+static void cmd_button_latency(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    bool reset = (argc == 2) && (strcmp(argv[1], "reset") == 0);
+    button_latency_t latency;
+    button_handler_get_latency(&latency, reset);
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "event         count   last_us    max_us  bound_us\n");
+    for (int i = 0; i < BUTTON_EVENT_COUNT; i++)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%-12s %6u %9u %9u %9u\n",
+                        button_handler_event_name((button_event_t)i),
+                        latency.count[i], latency.last_us[i], latency.max_us[i],
+                        button_handler_latency_bound_us((button_event_t)i));
+    }
+}
+
+static void cmd_perf(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if (!perf_is_enabled())
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Profiler disabled (build with ESTC_PERF_ENABLED=1)\n");
+        return;
+    }
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "probe                   count       min       avg       max (cycles)\n");
+    for (int i = 0; i < PERF_PROBE_COUNT; i++)
+    {
+        perf_stats_t stats;
+        perf_get((perf_probe_t)i, &stats);
+        if (stats.count == 0) continue;
+
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%-21s %7u %9u %9u %9u\n",
+                        perf_probe_name((perf_probe_t)i), stats.count, stats.min,
+                        (uint32_t)(stats.total / stats.count), stats.max);
+
+        // Гистограмма: "<2^k:n" - n замеров короче 2^k тактов
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  hist");
+        for (int bin = 0; bin < PERF_HIST_BINS; bin++)
+        {
+            if (stats.hist[bin] != 0)
+            {
+                nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, " <2^%d:%u", bin, stats.hist[bin]);
+            }
+        }
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\n");
+    }
+
+    if ((argc == 2) && (strcmp(argv[1], "reset") == 0))
+    {
+        perf_reset();
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Counters reset\n");
+    }
+}
+
+// Формат строк выгрузки трассы
+static bool m_trace_csv;
+
+static void trace_line(uint32_t index)
+{
+    trace_record_t record;
+    if (!trace_get(index, &record)) return;
+
+    if (m_trace_csv)
+    {
+        page_printf("%u,%s,%u,%u\n", record.time_us,
+                    trace_stage_name((trace_stage_t)record.stage), record.id, record.arg);
+    }
+    else
+    {
+        // Запись как есть (8 байт, little-endian)
+        uint8_t const * p_bytes = (uint8_t const *)&record;
+        for (uint32_t j = 0; j < sizeof(record); j++)
+        {
+            page_printf("%02x", p_bytes[j]);
+        }
+        page_printf("\n");
+    }
+}
+
+static void trace_done(void)
+{
+    trace_pause(false);
+}
+
+static void cmd_trace(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if (!trace_is_enabled())
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Tracer disabled (build with ESTC_TRACE_ENABLED=1)\n");
+        return;
+    }
+
+    if (argc == 1)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%u records. Usage: trace csv|hex [<offset> [<limit>]] | trace clear\n",
+                        trace_count());
+        return;
+    }
+
+    if ((argc == 2) && (strcmp(argv[1], "clear") == 0))
+    {
+        trace_clear();
+        return;
+    }
+
+    bool csv = (strcmp(argv[1], "csv") == 0);
+    if ((argc > 4) || (!csv && strcmp(argv[1], "hex") != 0))
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: trace csv|hex [<offset> [<limit>]] | trace clear\n");
+        return;
+    }
+
+    uint32_t offset = 0;
+    uint32_t limit  = TRACE_BUF_SIZE;
+    if ((argc >= 3) && !arg_uint(p_cli, "offset", argv[2], 0, TRACE_BUF_SIZE, &offset)) return;
+    if ((argc == 4) && !arg_uint(p_cli, "limit", argv[3], 1, TRACE_BUF_SIZE, &limit)) return;
+
+    // Во время выгрузки новые записи не принимаются
+    trace_pause(true);
+
+    uint32_t count = trace_count();
+    uint32_t first = MIN(offset, count);
+
+    m_trace_csv = csv;
+    if (csv)
+    {
+        page_printf("time_us,stage,id,arg\n");
+    }
+    page_start(trace_line, first, MIN(first + limit, count), trace_done);
+}
+
+static void cmd_mem(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    mem_section_t sections[8];
+    uint32_t count = mem_monitor_sections(sections, ARRAY_SIZE(sections));
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "section        start    size\n");
+    for (uint32_t i = 0; i < count; i++)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%-9s 0x%08x %7u\n",
+                        sections[i].name, sections[i].start, sections[i].size);
+    }
+
+    mem_usage_t usage;
+    mem_monitor_get(&usage);
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "stack: %u bytes, peak %u (%u%%), current %u\n",
+                    usage.stack_size, usage.stack_peak,
+                    usage.stack_peak * 100 / usage.stack_size, usage.stack_current);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "heap:  %u bytes, peak %u, in use %u\n",
+                    usage.heap_size, usage.heap_peak, usage.heap_in_use);
+}
+
+static void cmd_bin_stats(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    bin_proto_stats_t stats;
+    bin_proto_get_stats(&stats);
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Binary frames: %u, crc errors: %u, overruns: %u, seq gaps: %u, replies dropped: %u\n",
+                    stats.frames, stats.crc_errors, stats.overruns, stats.seq_gaps, stats.tx_dropped);
+}
+
+static void cmd_stream(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if ((argc == 2) && (strcmp(argv[1], "stats") == 0))
+    {
+        color_stream_stats_t stats;
+        color_stream_get_stats(&stats);
+
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "received=%u latched=%u underruns=%u overruns=%u skipped=%u bad=%u\n",
+                        stats.received, stats.latched, stats.underruns, stats.overruns,
+                        stats.skipped, stats.bad_frames);
+        return;
+    }
+
+    if (argc > 3)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: stream [<rate_hz> [<depth>]] | stream stats\n");
+        return;
+    }
+
+    uint32_t rate_hz = 100;
+    uint32_t depth   = STREAM_DEPTH_DEFAULT;
+
+    if ((argc >= 2) && !arg_uint(p_cli, "rate", argv[1], STREAM_RATE_MIN_HZ, STREAM_RATE_MAX_HZ, &rate_hz)) return;
+    if ((argc == 3) && !arg_uint(p_cli, "depth", argv[2], 1, STREAM_BUF_SIZE / 2, &depth)) return;
+
+    if (!color_stream_start(rate_hz, depth))
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Stream start failed: rate=%u Hz depth=%u\n", rate_hz, depth);
+        return;
+    }
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Streaming at %u Hz, %u frames buffered. Send <r> <g> <b> 0xFF (0-254), extra 0xFF to exit\n",
+                    rate_hz, depth);
+}
+
+static void cmd_usb_stats(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    bool reset = (argc == 2) && (strcmp(argv[1], "reset") == 0);
+    usb_cdc_stats_t stats;
+    usb_cdc_get_stats(&stats, reset);
+
+    uint32_t elapsed_ms = stats.elapsed_us / 1000;
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "rx: %u bytes, %u packets, %u stalls in %u ms (%u bytes/s)\n",
+                    stats.rx_bytes, stats.rx_packets, stats.rx_stalls, elapsed_ms,
+                    (elapsed_ms != 0) ? (uint32_t)((uint64_t)stats.rx_bytes * 1000 / elapsed_ms) : 0);
+
+    if (usb_hid_is_enabled())
+    {
+        usb_hid_stats_t hid;
+        usb_hid_get_stats(&hid, reset);
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "hid: %u colors, %u commands, %u dropped, %u bad, %u replies lost\n",
+                        hid.color_reports, hid.cmd_reports, hid.cmd_dropped, hid.bad_reports, hid.reply_dropped);
+    }
+    else
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "hid: build with ESTC_USB_HID_ENABLED=1\n");
+    }
+
+    if (!perf_is_enabled())
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "CPU per KB: build with ESTC_PERF_ENABLED=1\n");
+        return;
+    }
+
+    // Прерывание приема и разбор в основном цикле
+    perf_stats_t evt;
+    perf_stats_t parse;
+    perf_get(PERF_PROBE_USB_RX_EVT, &evt);
+    perf_get(PERF_PROBE_USB_RX_PARSE, &parse);
+
+    uint64_t cycles = evt.total + parse.total;
+    uint32_t kbytes = stats.rx_bytes / 1024;
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "CPU: %u cycles/KB (irq %u, parse %u cycles total)\n",
+                    (kbytes != 0) ? (uint32_t)(cycles / kbytes) : 0,
+                    (uint32_t)evt.total, (uint32_t)parse.total);
+    if (reset)
+    {
+        perf_reset();
+    }
+}
+
+static void cmd_machine(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    bool on = (argc == 2) && (strcmp(argv[1], "on") == 0);
+    if ((argc != 2) || (!on && strcmp(argv[1], "off") != 0))
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: machine on|off\n");
+        return;
+    }
+
+    if (on)
+    {
+        m_prompt[0] = '\0';
+    }
+    else
+    {
+        strcpy(m_prompt, CLI_PROMPT);
+    }
+#if ESTC_USB_CLI_COMPACT
+    cli_compact_echo_set(!on);
+#else
+    m_p_inject    = on ? "cli echo off\rcli colors off\r" : "cli echo on\rcli colors on\r";
+    m_inject_mute = true;
+#endif
+}
+
+static void cmd_strip(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if ((argc == 2) && (strcmp(argv[1], "stats") == 0))
+    {
+        ws2812_stats_t stats;
+        ws2812_handler_get_stats(&stats);
+
+        uint32_t frame_us = ws2812_handler_frame_time_us();
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "pixels=%u frame=%u us (max %u fps) shown=%u replaced=%u\n",
+                        ws2812_handler_length(), frame_us, 1000000 / frame_us,
+                        stats.frames_shown, stats.frames_replaced);
+        return;
+    }
+
+    if ((argc == 3) && (strcmp(argv[1], "length") == 0))
+    {
+        uint32_t length;
+        if (!arg_uint(p_cli, "length", argv[2], 1, WS2812_MAX_PIXELS, &length)) return;
+
+        if (!ws2812_handler_set_length(length))
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Strip is busy, try again\n");
+        }
+        return;
+    }
+
+    if (argc != 4 && argc != 2)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Usage: strip <r> <g> <b> | strip #RRGGBB | strip length <n> | strip stats\n");
+        return;
+    }
+
+    uint32_t r, g, b;
+    if (!arg_rgb(p_cli, &argv[1], argc - 1, &r, &g, &b)) return;
+
+    ws2812_handler_fill(r, g, b);
+    ws2812_handler_show();
+}
+
 static void cmd_help(nrf_cli_t const * p_cli, size_t argc, char ** argv)
 {
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Supported commands:\n");
-    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  RGB <r> <g> <b>   - Set color using RGB values (0-255)\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  RGB <r> <g> <b>   - Set color using RGB values (0-255, decimal or 0x hex) or #RRGGBB\n");
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  HSV <h> <s> <v>   - Set color using HSV model (H:0-360, S:0-100, V:0-100)\n");
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  add_rgb_color ... - Save RGB color to list\n");
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  add_hsv_color ... - Save HSV color to list\n");
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  add_current_color - Save current color\n");
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  del_color <name>  - Delete color from list\n");
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  apply_color <name>- Apply saved color\n");
-    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  list_colors       - Show saved colors\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  list_colors ...   - Show saved colors, optionally <offset> [<limit>]\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  render_stats      - Show render cache counters\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  flash_stats       - Show flash wear and commit counters\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  button_timing ... - Show/set button gesture timings\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  button_latency    - Show gesture classification latency\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  perf [reset]      - Show/reset cycle profiler counters\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  trace ...         - Export latency trace (csv|hex [<offset> [<limit>]]) or clear it\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  mem               - Show RAM sections and stack/heap peaks\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  stream ...        - Raw RGB frame streaming at a fixed rate (or stats)\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  usb_stats [reset] - Show USB receive throughput, HID counters and CPU cost\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  bin_stats         - Show binary protocol counters\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  machine on|off    - No echo, colors or prompt (for scripts)\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  strip ...         - WS2812 strip: fill color, set length or stats\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  Commands on one line may be separated by ';', flash is written once per line\n");
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  help              - Print information about supported commands\n");
 }
 
+// Список команд: X(имя, обработчик, точка замера) - с замером тактов и
+// отметкой в трассе, Y(имя, обработчик) - без. Из этого же списка
+// scripts/cli_phash.py строит таблицу хеша для ESTC_USB_CLI_COMPACT
+#define USB_CLI_COMMANDS(X, Y)                                          \
+    X(RGB,               cmd_rgb,               CMD_RGB)                \
+    X(HSV,               cmd_hsv,               CMD_HSV)                \
+    X(add_rgb_color,     cmd_add_rgb_color,     CMD_ADD_RGB)            \
+    X(add_hsv_color,     cmd_add_hsv_color,     CMD_ADD_HSV)            \
+    X(add_current_color, cmd_add_current_color, CMD_ADD_CURRENT)        \
+    X(del_color,         cmd_del_color,         CMD_DEL)                \
+    X(apply_color,       cmd_apply_color,       CMD_APPLY)              \
+    X(list_colors,       cmd_list_colors,       CMD_LIST)               \
+    X(render_stats,      cmd_render_stats,      CMD_RENDER_STATS)       \
+    X(flash_stats,       cmd_flash_stats,       CMD_FLASH_STATS)        \
+    X(button_timing,     cmd_button_timing,     CMD_BUTTON_TIMING)      \
+    X(button_latency,    cmd_button_latency,    CMD_BUTTON_LATENCY)     \
+    X(help,              cmd_help,              CMD_HELP)               \
+    X(perf,              cmd_perf,              CMD_PERF)               \
+    X(trace,             cmd_trace,             CMD_TRACE)              \
+    X(mem,               cmd_mem,               CMD_MEM)                \
+    X(bin_stats,         cmd_bin_stats,         CMD_BIN_STATS)          \
+    X(stream,            cmd_stream,            CMD_STREAM)             \
+    X(usb_stats,         cmd_usb_stats,         CMD_USB_STATS)          \
+    X(machine,           cmd_machine,           CMD_MACHINE)            \
+    X(strip,             cmd_strip,             CMD_STRIP)
+
+// С ESTC_PERF_ENABLED/ESTC_TRACE_ENABLED обработчик оборачивается замером
+// тактов и отметкой в трассе
+#if ESTC_PERF_ENABLED || ESTC_TRACE_ENABLED
+#define CLI_CMD_WRAP(name, handler, probe)                                          \
+    static void handler##_wrap(nrf_cli_t const * p_cli, size_t argc, char ** argv) \
+    {                                                                               \
+        TRACE(CLI_HANDLER, 0, PERF_PROBE_##probe);                                  \
+        PERF_BEGIN(probe);                                                          \
+        handler(p_cli, argc, argv);                                                 \
+        PERF_END(probe);                                                            \
+    }
+#define CLI_CMD_HANDLER(handler)    handler##_wrap
+#else
+#define CLI_CMD_WRAP(name, handler, probe)
+#define CLI_CMD_HANDLER(handler)    handler
+#endif
+#define CLI_CMD_NO_WRAP(name, handler)
+
+USB_CLI_COMMANDS(CLI_CMD_WRAP, CLI_CMD_NO_WRAP)
+
 // Регистрация команд
-NRF_CLI_CMD_REGISTER(RGB, NULL, NULL, cmd_rgb);
-NRF_CLI_CMD_REGISTER(HSV, NULL, NULL, cmd_hsv);
-NRF_CLI_CMD_REGISTER(add_rgb_color, NULL, NULL, cmd_add_rgb_color);
-NRF_CLI_CMD_REGISTER(add_hsv_color, NULL, NULL, cmd_add_hsv_color);
-NRF_CLI_CMD_REGISTER(add_current_color, NULL, NULL, cmd_add_current_color);
-NRF_CLI_CMD_REGISTER(del_color, NULL, NULL, cmd_del_color);
-NRF_CLI_CMD_REGISTER(apply_color, NULL, NULL, cmd_apply_color);
-NRF_CLI_CMD_REGISTER(list_colors, NULL, NULL, cmd_list_colors);
-NRF_CLI_CMD_REGISTER(help, NULL, NULL, cmd_help);
+#if ESTC_USB_CLI_COMPACT
+#define CLI_CMD_ENTRY(name, handler, probe)     { #name, CLI_CMD_HANDLER(handler) },
+#define CLI_CMD_ENTRY_PLAIN(name, handler)      { #name, handler },
+
+static const cli_compact_cmd_t m_cli_commands[] = {
+    USB_CLI_COMMANDS(CLI_CMD_ENTRY, CLI_CMD_ENTRY_PLAIN)
+};
+#else
+#define CLI_CMD_REGISTER(name, handler, probe)  NRF_CLI_CMD_REGISTER(name, NULL, NULL, CLI_CMD_HANDLER(handler));
+#define CLI_CMD_REGISTER_PLAIN(name, handler)   NRF_CLI_CMD_REGISTER(name, NULL, NULL, handler);
+
+USB_CLI_COMMANDS(CLI_CMD_REGISTER, CLI_CMD_REGISTER_PLAIN)
+#endif
 
 
 // Логика USB 
@@ -188,6 +1057,9 @@ static void usbd_user_ev_handler(app_usbd_event_type_t event)
 {
     switch (event)
     {
+        case APP_USBD_EVT_DRV_SUSPEND:
+            m_port_lost = true;
+            break;
         case APP_USBD_EVT_STOPPED:
             app_usbd_disable();
             break;
@@ -198,6 +1070,7 @@ static void usbd_user_ev_handler(app_usbd_event_type_t event)
             }
             break;
         case APP_USBD_EVT_POWER_REMOVED:
+            m_port_lost = true;
             app_usbd_stop();
             break;
         case APP_USBD_EVT_POWER_READY:
@@ -214,7 +1087,11 @@ void usb_cli_init(void)
 {
     ret_code_t ret;
 
+#if ESTC_USB_CLI_COMPACT
+    ret = cli_compact_init(&m_mux_transport, m_prompt, m_cli_commands, ARRAY_SIZE(m_cli_commands));
+#else
     ret = nrf_cli_init(&m_cli_cdc_acm, NULL, true, true, NRF_LOG_SEVERITY_INFO);
+#endif
     APP_ERROR_CHECK(ret);
 
     static const app_usbd_config_t usbd_config = {
@@ -225,20 +1102,65 @@ void usb_cli_init(void)
     ret = app_usbd_init(&usbd_config);
     APP_ERROR_CHECK(ret);
 
-    app_usbd_class_inst_t const * class_cdc_acm = app_usbd_cdc_acm_class_inst_get(&nrf_cli_cdc_acm);
-    ret = app_usbd_class_append(class_cdc_acm);
+    ret = app_usbd_class_append(usb_cdc_class_inst());
+    APP_ERROR_CHECK(ret);
+
+#if ESTC_USB_HID_ENABLED
+    // Составное устройство: CDC ACM для CLI и HID для управления с задержкой до 2 мс
+    ret = app_usbd_class_append(usb_hid_class_inst());
     APP_ERROR_CHECK(ret);
+#endif
 
     ret = app_usbd_power_events_enable();
     APP_ERROR_CHECK(ret);
 
+#if !ESTC_USB_CLI_COMPACT
     ret = nrf_cli_start(&m_cli_cdc_acm);
     APP_ERROR_CHECK(ret);
+#endif
 }
 
 void usb_cli_process(void)
 {
-    nrf_cli_process(&m_cli_cdc_acm);
+    // Команды HID не ждут окончания вывода CLI
+    usb_hid_process();
+
+    if (m_port_lost)
+    {
+        m_port_lost = false;
+        if (color_stream_is_active())
+        {
+            stream_finish();
+        }
+    }
+
+    // Остаток ответов двоичного протокола
+    if (m_bin_tx_len != 0)
+    {
+        bin_tx_flush();
+    }
+
+    // Пока идет отложенный вывод, команды не читаются
+    if (!page_is_active())
+    {
+#if ESTC_USB_CLI_COMPACT
+        cli_compact_process();
+#else
+        nrf_cli_process(&m_cli_cdc_acm);
+#endif
+
+        if (m_batch_end_pending)
+        {
+            m_batch_end_pending = false;
+            app_logic_batch_end();
+        }
+    }
+
+    // Первая передача - сразу после команды, следующие - по USB_CDC_EVT_TX_DONE
+    if (page_is_active())
+    {
+        page_process();
+    }
 }
 
 #else
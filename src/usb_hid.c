@@ -0,0 +1,176 @@
+#include "usb_hid.h"
+#include <string.h>
+
+#if ESTC_USB_HID_ENABLED
+
+#include "app_usbd_hid_generic.h"
+#include "app_util_platform.h"
+#include "app_logic.h"
+#include "bin_proto.h"
+#include "trace.h"
+
+// CDC ACM занимает интерфейсы 0-1 и конечные точки EPIN1, EPIN2, EPOUT1
+#define HID_INTERFACE       2
+#define HID_EPIN            NRF_DRV_USBD_EPIN3
+#define HID_EPOUT           NRF_DRV_USBD_EPOUT2
+
+#define REPORT_ID_COLOR     1
+#define REPORT_ID_CMD       2
+
+// Ответ: seq, cmd, status, len, данные
+#define REPLY_REPORT_SIZE   (4 + BIN_PROTO_MAX_REPLY)
+// Ответов в очереди IN класса
+#define REPLY_QUEUE_SIZE    4
+
+#define RESPONSE_FLAG       0x80
+#define CMD_MASK            (USB_HID_CMD_QUEUE_SIZE - 1)
+
+// Отчеты производителя (0xFF00): номер 1 - цвет, номер 2 - команда и ответ
+APP_USBD_HID_GENERIC_SUBCLASS_REPORT_DESC(m_report_desc, {
+    0x06, 0x00, 0xFF,                       // Usage Page (Vendor 0xFF00)
+    0x09, 0x01,                             // Usage (0x01)
+    0xA1, 0x01,                             // Collection (Application)
+    0x15, 0x00,                             //   Logical Minimum (0)
+    0x26, 0xFF, 0x00,                       //   Logical Maximum (255)
+    0x75, 0x08,                             //   Report Size (8)
+    0x85, REPORT_ID_COLOR,                  //   Report ID (1)
+    0x95, USB_HID_COLOR_REPORT_SIZE,        //   Report Count
+    0x09, 0x02,                             //   Usage (0x02)
+    0x91, 0x02,                             //   Output (Data, Var, Abs)
+    0x85, REPORT_ID_CMD,                    //   Report ID (2)
+    0x95, USB_HID_CMD_REPORT_SIZE,          //   Report Count
+    0x09, 0x03,                             //   Usage (0x03)
+    0x91, 0x02,                             //   Output (Data, Var, Abs)
+    0x95, REPLY_REPORT_SIZE,                //   Report Count
+    0x09, 0x04,                             //   Usage (0x04)
+    0x81, 0x02,                             //   Input (Data, Var, Abs)
+    0xC0                                    // End Collection
+});
+
+static const app_usbd_hid_subclass_desc_t * m_hid_descs[] = {&m_report_desc};
+
+static void hid_user_ev_handler(app_usbd_class_inst_t const * p_inst,
+                                app_usbd_hid_user_event_t event);
+
+// Интервал опроса конечных точек - по умолчанию класса, 1 мс.
+// Feature-отчеты не используются
+APP_USBD_HID_GENERIC_GLOBAL_DEF(m_hid_generic,
+                                HID_INTERFACE,
+                                hid_user_ev_handler,
+                                (HID_EPIN, HID_EPOUT),
+                                m_hid_descs,
+                                REPLY_QUEUE_SIZE,
+                                USB_HID_CMD_REPORT_SIZE,
+                                0,
+                                APP_USBD_HID_SUBCLASS_NONE,
+                                APP_USBD_HID_PROTO_GENERIC);
+
+// Очередь команд: head заполняет прерывание USB, tail освобождает основной цикл
+static uint8_t           m_cmd_queue[USB_HID_CMD_QUEUE_SIZE][USB_HID_CMD_REPORT_SIZE];
+static volatile uint32_t m_cmd_head;
+static volatile uint32_t m_cmd_tail;
+
+static usb_hid_stats_t   m_stats;
+
+// Разбор отчета OUT. Вызывается из прерывания USB
+static void report_received(uint8_t const * p_report, size_t size)
+{
+    if (size == 1 + USB_HID_COLOR_REPORT_SIZE && p_report[0] == REPORT_ID_COLOR)
+    {
+        TRACE(HID_RX, REPORT_ID_COLOR, 0);
+        // ШИМ пишет только app_logic: цвет выводится в основном цикле
+        app_logic_post_rgb(p_report[1] | (p_report[2] << 8),
+                           p_report[3] | (p_report[4] << 8),
+                           p_report[5] | (p_report[6] << 8));
+        m_stats.color_reports++;
+        return;
+    }
+
+    if (size == 1 + USB_HID_CMD_REPORT_SIZE && p_report[0] == REPORT_ID_CMD &&
+        p_report[3] <= USB_HID_CMD_DATA_MAX)
+    {
+        TRACE(HID_RX, REPORT_ID_CMD, p_report[2]);
+        if (m_cmd_head - m_cmd_tail == USB_HID_CMD_QUEUE_SIZE)
+        {
+            m_stats.cmd_dropped++;
+            return;
+        }
+        memcpy(m_cmd_queue[m_cmd_head & CMD_MASK], &p_report[1], USB_HID_CMD_REPORT_SIZE);
+        m_cmd_head++;
+        return;
+    }
+
+    m_stats.bad_reports++;
+}
+
+static void hid_user_ev_handler(app_usbd_class_inst_t const * p_inst,
+                                app_usbd_hid_user_event_t event)
+{
+    switch (event)
+    {
+        case APP_USBD_HID_USER_EVT_OUT_REPORT_READY:
+        {
+            size_t size;
+            uint8_t const * p_report = app_usbd_hid_generic_out_report_get(&m_hid_generic, &size);
+            report_received(p_report, size);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+app_usbd_class_inst_t const * usb_hid_class_inst(void)
+{
+    return app_usbd_hid_generic_class_inst_get(&m_hid_generic);
+}
+
+void usb_hid_process(void)
+{
+    while (m_cmd_tail != m_cmd_head)
+    {
+        uint8_t const * p_cmd = m_cmd_queue[m_cmd_tail & CMD_MASK];
+        uint8_t reply[1 + REPLY_REPORT_SIZE] = {0};
+        uint32_t reply_len;
+
+        reply[0] = REPORT_ID_CMD;
+        reply[1] = p_cmd[0];
+        reply[2] = p_cmd[1] | RESPONSE_FLAG;
+        reply[3] = bin_proto_execute(p_cmd[1], &p_cmd[3], p_cmd[2], &reply[5], &reply_len);
+        reply[4] = reply_len;
+        m_cmd_tail++;
+        m_stats.cmd_reports++;
+
+        // Хост не читает ответы или устройство не сконфигурировано
+        if (app_usbd_hid_generic_in_report_set(&m_hid_generic, reply, sizeof(reply)) != NRF_SUCCESS)
+        {
+            m_stats.reply_dropped++;
+        }
+    }
+}
+
+void usb_hid_get_stats(usb_hid_stats_t * p_stats, bool reset)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats;
+    if (reset)
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+bool usb_hid_is_enabled(void)
+{
+    return true;
+}
+
+#else
+
+app_usbd_class_inst_t const * usb_hid_class_inst(void) { return NULL; }
+void usb_hid_process(void) {}
+void usb_hid_get_stats(usb_hid_stats_t * p_stats, bool reset) { memset(p_stats, 0, sizeof(*p_stats)); }
+bool usb_hid_is_enabled(void) { return false; }
+
+#endif
@@ -0,0 +1,187 @@
+#include "ws2812_handler.h"
+#include "nrfx_pwm.h"
+#include "nrf_pwm.h"
+#include "app_util_platform.h"
+#include <string.h>
+
+// Тайминги при тактировании 16 МГц: период бита 20 тактов = 1.25 мкс
+#define WS2812_PWM_TOP          20
+#define WS2812_T0H              6       // 0.375 мкс
+#define WS2812_T1H              13      // 0.8125 мкс
+// Старший бит: первый фронт в периоде - спадающий (высокий уровень до сравнения)
+#define WS2812_POLARITY         0x8000
+#define WS2812_BIT_0            (WS2812_POLARITY | WS2812_T0H)
+#define WS2812_BIT_1            (WS2812_POLARITY | WS2812_T1H)
+#define WS2812_BIT_LOW          (WS2812_POLARITY | 0)
+
+#define WS2812_BITS_PER_PIXEL   24
+// Сброс ленты: >280 мкс низкого уровня (240 периодов = 300 мкс)
+#define WS2812_RESET_PERIODS    240
+#define WS2812_PERIOD_NS        1250
+
+#define WS2812_DMA_LEN          (WS2812_MAX_PIXELS * WS2812_BITS_PER_PIXEL + 1)
+
+static nrfx_pwm_t m_pwm_instance = NRFX_PWM_INSTANCE(1);
+
+// Буфер кадра (RGB) и два DMA буфера с закодированным потоком
+static uint8_t  m_pixels[WS2812_MAX_PIXELS][3];
+static uint16_t m_dma_buf[2][WS2812_DMA_LEN];
+
+static uint16_t m_pixel_count;
+static uint8_t  m_active_buf;
+static volatile bool m_busy    = false;
+static volatile bool m_pending = false;
+
+static ws2812_stats_t m_stats;
+
+// Запуск передачи DMA буфера
+static void start_playback(uint8_t buf)
+{
+    nrf_pwm_sequence_t seq;
+    seq.values.p_common = m_dma_buf[buf];
+    seq.length          = m_pixel_count * WS2812_BITS_PER_PIXEL + 1;
+    seq.repeats         = 0;
+    seq.end_delay       = WS2812_RESET_PERIODS;
+
+    m_active_buf = buf;
+    m_busy = true;
+    m_stats.frames_shown++;
+    nrfx_pwm_simple_playback(&m_pwm_instance, &seq, 1,
+                             NRFX_PWM_FLAG_STOP | NRFX_PWM_FLAG_NO_EVT_FINISHED);
+}
+
+// Обработчик событий ШИМ. Следующий кадр запускается по STOPPED, а не по
+// FINISHED: сокращение LOOPSDONE->STOP останавливает ШИМ после FINISHED
+// и оборвало бы запущенное из него воспроизведение
+static void ws2812_pwm_handler(nrfx_pwm_evt_type_t event_type)
+{
+    if (event_type != NRFX_PWM_EVT_STOPPED) return;
+
+    if (m_pending)
+    {
+        // Следующий кадр уже закодирован -> сразу отправляем
+        m_pending = false;
+        start_playback(m_active_buf ^ 1);
+    }
+    else
+    {
+        m_busy = false;
+    }
+}
+
+// Кодирование буфера кадра в поток (порядок байт GRB, старший бит первым)
+static void encode_frame(uint16_t * p_out)
+{
+    for (uint16_t i = 0; i < m_pixel_count; i++)
+    {
+        uint32_t grb = ((uint32_t)m_pixels[i][1] << 16) |
+                       ((uint32_t)m_pixels[i][0] << 8)  |
+                       m_pixels[i][2];
+
+        for (uint32_t mask = 1UL << 23; mask != 0; mask >>= 1)
+        {
+            *p_out++ = (grb & mask) ? WS2812_BIT_1 : WS2812_BIT_0;
+        }
+    }
+    // Последнее значение удерживается на время сброса
+    *p_out = WS2812_BIT_LOW;
+}
+
+// Инициализация
+void ws2812_handler_init(uint32_t data_pin, uint16_t pixel_count)
+{
+    nrfx_pwm_config_t config = NRFX_PWM_DEFAULT_CONFIG;
+
+    config.output_pins[0] = data_pin;
+    config.output_pins[1] = NRFX_PWM_PIN_NOT_USED;
+    config.output_pins[2] = NRFX_PWM_PIN_NOT_USED;
+    config.output_pins[3] = NRFX_PWM_PIN_NOT_USED;
+
+    config.base_clock = NRF_PWM_CLK_16MHz;
+    config.count_mode = NRF_PWM_MODE_UP;
+    config.top_value  = WS2812_PWM_TOP;
+    config.load_mode  = NRF_PWM_LOAD_COMMON;
+    config.step_mode  = NRF_PWM_STEP_AUTO;
+
+    nrfx_pwm_init(&m_pwm_instance, &config, ws2812_pwm_handler);
+
+    m_pixel_count = (pixel_count > WS2812_MAX_PIXELS) ? WS2812_MAX_PIXELS : pixel_count;
+    memset(m_pixels, 0, sizeof(m_pixels));
+
+    // Гасим ленту при старте
+    ws2812_handler_show();
+}
+
+bool ws2812_handler_set_length(uint16_t pixel_count)
+{
+    // Длина передаваемого и ожидающего кадра уже задана кодированием
+    if (m_busy) return false;
+
+    m_pixel_count = (pixel_count > WS2812_MAX_PIXELS) ? WS2812_MAX_PIXELS : pixel_count;
+    return true;
+}
+
+uint16_t ws2812_handler_length(void)
+{
+    return m_pixel_count;
+}
+
+void ws2812_handler_set_pixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (index >= m_pixel_count) return;
+
+    m_pixels[index][0] = r;
+    m_pixels[index][1] = g;
+    m_pixels[index][2] = b;
+}
+
+void ws2812_handler_fill(uint8_t r, uint8_t g, uint8_t b)
+{
+    for (uint16_t i = 0; i < m_pixel_count; i++)
+    {
+        ws2812_handler_set_pixel(i, r, g, b);
+    }
+}
+
+void ws2812_handler_show(void)
+{
+    // Забираем свободный буфер: пока флаг снят, прерывание его не запустит
+    CRITICAL_REGION_ENTER();
+    if (m_pending)
+    {
+        m_pending = false;
+        m_stats.frames_replaced++;
+    }
+    CRITICAL_REGION_EXIT();
+
+    uint8_t back_buf = m_busy ? (m_active_buf ^ 1) : m_active_buf;
+    encode_frame(m_dma_buf[back_buf]);
+
+    CRITICAL_REGION_ENTER();
+    if (m_busy)
+    {
+        // Отправится по окончании текущего кадра
+        m_pending = true;
+    }
+    else
+    {
+        start_playback(back_buf);
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+bool ws2812_handler_is_busy(void)
+{
+    return m_busy;
+}
+
+uint32_t ws2812_handler_frame_time_us(void)
+{
+    uint32_t periods = (uint32_t)m_pixel_count * WS2812_BITS_PER_PIXEL + 1 + WS2812_RESET_PERIODS;
+    return (periods * WS2812_PERIOD_NS) / 1000;
+}
+
+void ws2812_handler_get_stats(ws2812_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}